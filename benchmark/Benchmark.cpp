@@ -0,0 +1,58 @@
+/******************************************************************************
+ * The MIT License(MIT)
+ *
+ * Copyright(c) 2015 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+#include <stdio.h>
+#include "Benchmark.h"
+
+namespace
+{
+const void* volatile gKept = nullptr;
+}
+
+namespace nyra
+{
+namespace benchmark
+{
+/*****************************************************************************/
+void report(const std::string& name, double milliseconds, double baseline)
+{
+    if (baseline > 0.0 && milliseconds > 0.0)
+    {
+        printf("  %-48s %10.3f ms %8.2fx\n",
+               name.c_str(),
+               milliseconds,
+               baseline / milliseconds);
+    }
+    else
+    {
+        printf("  %-48s %10.3f ms\n", name.c_str(), milliseconds);
+    }
+}
+
+/*****************************************************************************/
+void keep(const void* result)
+{
+    gKept = result;
+}
+}
+}
@@ -0,0 +1,103 @@
+/******************************************************************************
+ * The MIT License(MIT)
+ *
+ * Copyright(c) 2015 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+#ifndef __NYRA_BENCHMARK_BENCHMARK_H__
+#define __NYRA_BENCHMARK_BENCHMARK_H__
+
+#include <stdint.h>
+#include <string>
+#include <chrono>
+#include <algorithm>
+
+namespace nyra
+{
+namespace benchmark
+{
+/*
+ *  \func measure
+ *  \brief Runs a function several times and gets the fastest run in
+ *         milliseconds, since that run was disturbed the least by the
+ *         rest of the system.
+ *
+ *  \param func A callable that takes no arguments.
+ *  \param repeats The number of times to run it.
+ */
+template <typename FuncT>
+double measure(FuncT func, size_t repeats = 5)
+{
+    double best = 0.0;
+    for (size_t ii = 0; ii < repeats; ++ii)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        func();
+        const std::chrono::duration<double, std::milli> elapsed =
+                std::chrono::steady_clock::now() - start;
+        best = ii ? std::min(best, elapsed.count()) : elapsed.count();
+    }
+    return best;
+}
+
+/*
+ *  \func report
+ *  \brief Prints one result.
+ *
+ *  \param name What was measured.
+ *  \param milliseconds The time it took.
+ *  \param baseline The time of the code it is compared against. If this
+ *         is not 0, the speedup over it is printed as well.
+ */
+void report(const std::string& name,
+            double milliseconds,
+            double baseline = 0.0);
+
+/*
+ *  \func keep
+ *  \brief Stops the optimizer from removing work whose result is never
+ *         read.
+ */
+void keep(const void* result);
+
+/*
+ *  The benchmarks. Each one sets up its own data and prints its results.
+ */
+void runFileLoader();
+
+void runMatrix();
+
+void runRasterizer();
+
+void runStringConvert();
+
+void runTextureAtlas();
+
+void runVectorLayout();
+
+void runVectorArithmetic();
+
+void runVectorExpression();
+
+void runWindowSDL();
+}
+}
+
+#endif
@@ -0,0 +1,88 @@
+/******************************************************************************
+ * The MIT License(MIT)
+ *
+ * Copyright(c) 2015 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+#include <string>
+#include <vector>
+#include <fstream>
+#include <filesystem>
+#include <core/File.h>
+#include <core/FileLoader.h>
+#include "Benchmark.h"
+
+namespace
+{
+const size_t NUM_FILES = 64;
+const size_t FILE_SIZE = 1024 * 1024;
+}
+
+namespace nyra
+{
+namespace benchmark
+{
+/*****************************************************************************/
+void runFileLoader()
+{
+    // The files were just written so they are read from the page cache.
+    // This measures the overlap of the reads themselves, not disk seeks.
+    const std::filesystem::path directory =
+            std::filesystem::temp_directory_path() / "nyra_file_loader";
+    std::filesystem::create_directories(directory);
+
+    std::vector<std::string> pathnames;
+    const std::vector<char> contents(FILE_SIZE, 'x');
+    for (size_t ii = 0; ii < NUM_FILES; ++ii)
+    {
+        pathnames.push_back(
+                (directory / ("file" + std::to_string(ii))).string());
+        std::ofstream stream(pathnames.back(), std::ios::binary);
+        stream.write(&contents[0], contents.size());
+    }
+
+    const double serial = measure([&pathnames]()
+    {
+        for (size_t ii = 0; ii < pathnames.size(); ++ii)
+        {
+            const std::vector<uint8_t> buffer =
+                    core::readBinary(pathnames[ii]);
+            keep(buffer.data());
+        }
+    });
+    report("readBinary loop", serial);
+
+    core::FileLoader loader;
+    const double batch = measure([&pathnames, &loader]()
+    {
+        std::vector<std::future<core::FileLoader::Buffer> > futures =
+                loader.load(pathnames);
+        for (size_t ii = 0; ii < futures.size(); ++ii)
+        {
+            const core::FileLoader::Buffer buffer = futures[ii].get();
+            keep(buffer.data());
+        }
+    });
+    report("FileLoader::load batch", batch, serial);
+
+    std::filesystem::remove_all(directory);
+}
+}
+}
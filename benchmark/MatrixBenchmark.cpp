@@ -0,0 +1,99 @@
+/******************************************************************************
+ * The MIT License(MIT)
+ *
+ * Copyright(c) 2015 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+#include <vector>
+#include <core/Matrix.h>
+#include <core/Quaternion.h>
+#include <core/ThreadPool.h>
+#include "Benchmark.h"
+
+namespace
+{
+const size_t NUM_POINTS = 10000000;
+}
+
+namespace nyra
+{
+namespace benchmark
+{
+/*****************************************************************************/
+void runMatrix()
+{
+    const core::Matrix4F matrix =
+            core::QuaternionF::fromAxisAngle(core::Vector3F(0.0f, 0.0f, 1.0f),
+                                             0.5f).toMatrix4() *
+            core::Matrix4F::translation(core::Vector3F(1.0f, 2.0f, 3.0f)) *
+            core::Matrix4F::scaling(core::Vector3F(2.0f, 3.0f, 4.0f));
+
+    std::vector<core::Vector3F> points(NUM_POINTS);
+    for (size_t ii = 0; ii < NUM_POINTS; ++ii)
+    {
+        points[ii] = core::Vector3F(static_cast<float>(ii % 100),
+                                    static_cast<float>(ii % 7),
+                                    static_cast<float>(ii % 13));
+    }
+    std::vector<core::Vector3F> out(NUM_POINTS);
+
+    const double scalar = measure([&]()
+    {
+        for (size_t ii = 0; ii < NUM_POINTS; ++ii)
+        {
+            core::MatrixLoops<float, 4>::transformPoint(matrix.data(),
+                                                        points[ii].data(),
+                                                        out[ii].data());
+        }
+        keep(out.data());
+    });
+    report("10M points, scalar loop", scalar);
+
+    const double single = measure([&]()
+    {
+        for (size_t ii = 0; ii < NUM_POINTS; ++ii)
+        {
+            out[ii] = matrix.transformPoint(points[ii]);
+        }
+        keep(out.data());
+    });
+    report("10M points, Matrix::transformPoint", single, scalar);
+
+    const double batch = measure([&]()
+    {
+        core::transformPoints(matrix, points.data(), out.data(), NUM_POINTS);
+        keep(out.data());
+    });
+    report("10M points, transformPoints", batch, scalar);
+
+    core::ThreadPool pool;
+    const double parallel = measure([&]()
+    {
+        core::transformPoints(matrix,
+                              points.data(),
+                              out.data(),
+                              NUM_POINTS,
+                              &pool);
+        keep(out.data());
+    });
+    report("10M points, transformPoints with pool", parallel, scalar);
+}
+}
+}
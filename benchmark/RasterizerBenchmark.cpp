@@ -0,0 +1,175 @@
+/******************************************************************************
+ * The MIT License(MIT)
+ *
+ * Copyright(c) 2015 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+#include <random>
+#include <vector>
+#include <core/ThreadPool.h>
+#include <graphics/Rasterizer.h>
+#include <graphics/WindowHeadless.h>
+#include "Benchmark.h"
+
+namespace
+{
+const size_t WIDTH = 1920;
+const size_t HEIGHT = 1080;
+const size_t NUM_FRAMES = 30;
+const size_t NUM_SPRITES = 2000;
+const size_t NUM_TRIANGLES = 500;
+const size_t NUM_RECTS = 200;
+const size_t SPRITE_SIZE = 64;
+
+struct Scene
+{
+    std::vector<nyra::core::Vector2I> sprites;
+    std::vector<nyra::core::Vector2F> triangles;
+    std::vector<nyra::graphics::Rect> rects;
+};
+
+/*****************************************************************************/
+Scene makeScene()
+{
+    std::mt19937 random(1);
+    std::uniform_real_distribution<float> x(0.0f, WIDTH);
+    std::uniform_real_distribution<float> y(0.0f, HEIGHT);
+    std::uniform_real_distribution<float> offset(-40.0f, 40.0f);
+
+    Scene scene;
+    for (size_t ii = 0; ii < NUM_SPRITES; ++ii)
+    {
+        scene.sprites.push_back(nyra::core::Vector2I(
+                static_cast<ssize_t>(x(random)) - SPRITE_SIZE / 2,
+                static_cast<ssize_t>(y(random)) - SPRITE_SIZE / 2));
+    }
+    for (size_t ii = 0; ii < NUM_TRIANGLES; ++ii)
+    {
+        const nyra::core::Vector2F center(x(random), y(random));
+        for (size_t jj = 0; jj < 3; ++jj)
+        {
+            scene.triangles.push_back(nyra::core::Vector2F(
+                    center.x() + offset(random),
+                    center.y() + offset(random)));
+        }
+    }
+    for (size_t ii = 0; ii < NUM_RECTS; ++ii)
+    {
+        scene.rects.push_back(nyra::graphics::Rect(
+                static_cast<int32_t>(x(random)),
+                static_cast<int32_t>(y(random)),
+                static_cast<int32_t>(offset(random) + 60.0f),
+                static_cast<int32_t>(offset(random) + 60.0f)));
+    }
+    return scene;
+}
+
+/*****************************************************************************/
+void drawScene(const Scene& scene,
+               const nyra::graphics::PixelBuffer& sprite,
+               nyra::graphics::Rasterizer& rasterizer)
+{
+    using nyra::graphics::Color;
+    rasterizer.clear(Color(32, 32, 48));
+    for (size_t ii = 0; ii < scene.rects.size(); ++ii)
+    {
+        rasterizer.fillRect(scene.rects[ii], Color(200, 80, 40, 160));
+    }
+    for (size_t ii = 0; ii < scene.triangles.size(); ii += 3)
+    {
+        rasterizer.fillTriangle(scene.triangles[ii],
+                                scene.triangles[ii + 1],
+                                scene.triangles[ii + 2],
+                                Color(255, 0, 0),
+                                Color(0, 255, 0),
+                                Color(0, 0, 255, 128));
+    }
+    for (size_t ii = 0; ii < scene.sprites.size(); ++ii)
+    {
+        rasterizer.blit(sprite, scene.sprites[ii]);
+    }
+}
+}
+
+namespace nyra
+{
+namespace benchmark
+{
+/*****************************************************************************/
+void runRasterizer()
+{
+    const Scene scene = makeScene();
+
+    // A sprite with a solid middle and a translucent border so the blits
+    // exercise both the copy and the blend paths.
+    std::vector<uint8_t> spritePixels(SPRITE_SIZE * SPRITE_SIZE * 4);
+    for (size_t y = 0; y < SPRITE_SIZE; ++y)
+    {
+        for (size_t x = 0; x < SPRITE_SIZE; ++x)
+        {
+            uint8_t* pixel = &spritePixels[(y * SPRITE_SIZE + x) * 4];
+            const bool border = x < 8 || y < 8 ||
+                                x >= SPRITE_SIZE - 8 || y >= SPRITE_SIZE - 8;
+            pixel[0] = static_cast<uint8_t>(x * 4);
+            pixel[1] = static_cast<uint8_t>(y * 4);
+            pixel[2] = 128;
+            pixel[3] = border ? 96 : 255;
+        }
+    }
+    const graphics::PixelBuffer sprite(
+            &spritePixels[0],
+            core::Vector2UI(SPRITE_SIZE, SPRITE_SIZE),
+            graphics::BGRA8);
+
+    graphics::WindowHeadless window(core::Vector2UI(WIDTH, HEIGHT));
+    std::vector<uint8_t> frame(WIDTH * HEIGHT * 4);
+    graphics::Rasterizer rasterizer(&frame[0],
+                                    core::Vector2UI(WIDTH, HEIGHT),
+                                    graphics::BGRA8);
+
+    const double serial = measure([&]()
+    {
+        for (size_t ii = 0; ii < NUM_FRAMES; ++ii)
+        {
+            drawScene(scene, sprite, rasterizer);
+            rasterizer.flush();
+            window.showBuffer(rasterizer.getTarget());
+            window.finishFrame();
+        }
+    }) / NUM_FRAMES;
+    report("1080p scene per frame", serial);
+
+    core::ThreadPool pool;
+    const double parallel = measure([&]()
+    {
+        for (size_t ii = 0; ii < NUM_FRAMES; ++ii)
+        {
+            drawScene(scene, sprite, rasterizer);
+            rasterizer.flush(&pool);
+            window.showBuffer(rasterizer.getTarget());
+            window.finishFrame();
+        }
+    }) / NUM_FRAMES;
+    report("1080p scene per frame with pool", parallel, serial);
+    report("present per frame",
+           window.getTimings().getAverage() * 1000.0);
+}
+}
+}
@@ -0,0 +1,137 @@
+/******************************************************************************
+ * The MIT License(MIT)
+ *
+ * Copyright(c) 2015 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+#include <string>
+#include <vector>
+#include <sstream>
+#include <core/StringConvert.h>
+#include "Benchmark.h"
+
+namespace
+{
+const size_t NUM_VALUES = 1000000;
+
+// The stringstream conversions toType and toString used before they
+// were built on std::from_chars and std::to_chars.
+template <typename T>
+T streamToType(const std::string& s)
+{
+    if (s.empty())
+    {
+        throw nyra::core::Exception("Trying to covert an empty string.");
+    }
+
+    T value;
+    std::stringstream buffer(s);
+    buffer.precision(nyra::core::getPrecision<T>(value));
+    buffer >> value;
+    if (buffer.fail())
+    {
+        throw nyra::core::Exception("Failed to convert: " + s);
+    }
+    return value;
+}
+
+template <typename T>
+std::string streamToString(const T& value)
+{
+    std::ostringstream buffer;
+    buffer.precision(nyra::core::getPrecision<T>(value));
+    buffer << std::boolalpha << value;
+    return buffer.str();
+}
+
+template <typename T>
+void compare(const std::string& name, const std::vector<T>& values)
+{
+    std::vector<std::string> strings(values.size());
+    for (size_t ii = 0; ii < values.size(); ++ii)
+    {
+        strings[ii] = nyra::core::toString(values[ii]);
+    }
+
+    std::vector<T> parsed(values.size());
+    const double streamParse = nyra::benchmark::measure([&]()
+    {
+        for (size_t ii = 0; ii < strings.size(); ++ii)
+        {
+            parsed[ii] = streamToType<T>(strings[ii]);
+        }
+        nyra::benchmark::keep(parsed.data());
+    });
+    nyra::benchmark::report("stream toType<" + name + ">", streamParse);
+
+    const double charsParse = nyra::benchmark::measure([&]()
+    {
+        for (size_t ii = 0; ii < strings.size(); ++ii)
+        {
+            parsed[ii] = nyra::core::toType<T>(strings[ii]);
+        }
+        nyra::benchmark::keep(parsed.data());
+    });
+    nyra::benchmark::report("toType<" + name + ">", charsParse, streamParse);
+
+    const double streamFormat = nyra::benchmark::measure([&]()
+    {
+        for (size_t ii = 0; ii < values.size(); ++ii)
+        {
+            strings[ii] = streamToString(values[ii]);
+        }
+        nyra::benchmark::keep(strings.data());
+    });
+    nyra::benchmark::report("stream toString<" + name + ">", streamFormat);
+
+    const double charsFormat = nyra::benchmark::measure([&]()
+    {
+        for (size_t ii = 0; ii < values.size(); ++ii)
+        {
+            strings[ii] = nyra::core::toString(values[ii]);
+        }
+        nyra::benchmark::keep(strings.data());
+    });
+    nyra::benchmark::report("toString<" + name + ">",
+                            charsFormat,
+                            streamFormat);
+}
+}
+
+namespace nyra
+{
+namespace benchmark
+{
+/*****************************************************************************/
+void runStringConvert()
+{
+    std::vector<int32_t> integers(NUM_VALUES);
+    std::vector<double> reals(NUM_VALUES);
+    for (size_t ii = 0; ii < NUM_VALUES; ++ii)
+    {
+        integers[ii] = static_cast<int32_t>(ii * 2654435761u);
+        reals[ii] = static_cast<double>(integers[ii]) / 1024.0;
+    }
+
+    compare("int32_t", integers);
+    compare("double", reals);
+}
+}
+}
@@ -0,0 +1,140 @@
+/******************************************************************************
+ * The MIT License(MIT)
+ *
+ * Copyright(c) 2015 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+#include <algorithm>
+#include <random>
+#include <vector>
+#include <graphics/Rasterizer.h>
+#include <graphics/TextureAtlas.h>
+#include <graphics/WindowHeadless.h>
+#include "Benchmark.h"
+
+namespace
+{
+const size_t WIDTH = 1920;
+const size_t HEIGHT = 1080;
+const size_t NUM_FRAMES = 10;
+const size_t NUM_ROUNDS = 15;
+const size_t NUM_IMAGES = 1000;
+const size_t NUM_BLITS = 5000;
+}
+
+namespace nyra
+{
+namespace benchmark
+{
+/*****************************************************************************/
+void runTextureAtlas()
+{
+    // Many small sprites, each in its own allocation, as they would be
+    // when loaded one file at a time.
+    std::mt19937 random(1);
+    std::uniform_int_distribution<size_t> side(16, 48);
+    std::vector<std::vector<uint8_t> > images(NUM_IMAGES);
+    std::vector<graphics::PixelBuffer> buffers;
+    for (size_t ii = 0; ii < NUM_IMAGES; ++ii)
+    {
+        const core::Vector2UI size(side(random), side(random));
+        images[ii].assign(size.x() * size.y() * 4,
+                          static_cast<uint8_t>(ii));
+        for (size_t jj = 3; jj < images[ii].size(); jj += 8)
+        {
+            images[ii][jj] = 160;
+        }
+        buffers.push_back(graphics::PixelBuffer(&images[ii][0],
+                                                size,
+                                                graphics::BGRA8));
+    }
+
+    graphics::TextureAtlas atlas;
+    std::vector<graphics::TextureAtlas::Handle> handles(NUM_IMAGES);
+    const double pack = measure([&atlas, &buffers, &handles]()
+    {
+        atlas = graphics::TextureAtlas();
+        for (size_t ii = 0; ii < buffers.size(); ++ii)
+        {
+            handles[ii] = atlas.add(buffers[ii]);
+        }
+    });
+    report("pack 1000 images", pack);
+
+    std::uniform_int_distribution<size_t> image(0, NUM_IMAGES - 1);
+    std::uniform_int_distribution<ssize_t> x(-32, WIDTH);
+    std::uniform_int_distribution<ssize_t> y(-32, HEIGHT);
+    std::vector<size_t> order(NUM_BLITS);
+    std::vector<core::Vector2I> positions(NUM_BLITS);
+    for (size_t ii = 0; ii < NUM_BLITS; ++ii)
+    {
+        order[ii] = image(random);
+        positions[ii] = core::Vector2I(x(random), y(random));
+    }
+
+    graphics::WindowHeadless window(core::Vector2UI(WIDTH, HEIGHT));
+    std::vector<uint8_t> frame(WIDTH * HEIGHT * 4);
+    graphics::Rasterizer rasterizer(&frame[0],
+                                    core::Vector2UI(WIDTH, HEIGHT),
+                                    graphics::BGRA8);
+
+    const auto drawSeparate = [&]()
+    {
+        for (size_t ii = 0; ii < NUM_FRAMES; ++ii)
+        {
+            rasterizer.clear(graphics::Color(0, 0, 0));
+            for (size_t jj = 0; jj < NUM_BLITS; ++jj)
+            {
+                rasterizer.blit(buffers[order[jj]], positions[jj]);
+            }
+            rasterizer.flush();
+            window.showBuffer(rasterizer.getTarget());
+        }
+    };
+
+    const auto drawAtlas = [&]()
+    {
+        for (size_t ii = 0; ii < NUM_FRAMES; ++ii)
+        {
+            rasterizer.clear(graphics::Color(0, 0, 0));
+            for (size_t jj = 0; jj < NUM_BLITS; ++jj)
+            {
+                rasterizer.blit(atlas, handles[order[jj]], positions[jj]);
+            }
+            rasterizer.flush();
+            window.showBuffer(rasterizer.getTarget());
+        }
+    };
+
+    // The two take turns so a slow stretch of the machine lands on both.
+    double separate = 0.0;
+    double atlased = 0.0;
+    for (size_t ii = 0; ii < NUM_ROUNDS; ++ii)
+    {
+        const double separateRound = measure(drawSeparate, 1) / NUM_FRAMES;
+        const double atlasRound = measure(drawAtlas, 1) / NUM_FRAMES;
+        separate = ii ? std::min(separate, separateRound) : separateRound;
+        atlased = ii ? std::min(atlased, atlasRound) : atlasRound;
+    }
+    report("5000 blits per frame, separate images", separate);
+    report("5000 blits per frame, atlas", atlased, separate);
+}
+}
+}
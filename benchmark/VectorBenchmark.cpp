@@ -0,0 +1,349 @@
+/******************************************************************************
+ * The MIT License(MIT)
+ *
+ * Copyright(c) 2015 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+#include <stdio.h>
+#include <array>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <core/Vector.h>
+#include "Benchmark.h"
+
+namespace
+{
+const size_t NUM_VECTORS = 10000000;
+const size_t NUM_ARITHMETIC_FLOATS = 3 * 4 * 16 * 256;
+const size_t NUM_ARITHMETIC_PASSES = 1000;
+
+// Vector as it was before the element storage was redesigned. x and y are
+// references into the array, so every copy has to rebind them.
+template <typename TypeT, size_t SizeT>
+struct LegacyElements
+{
+    LegacyElements(std::array<TypeT, SizeT>&)
+    {
+    }
+};
+
+template <typename TypeT>
+struct LegacyElements<TypeT, 2>
+{
+    LegacyElements(std::array<TypeT, 2>& array) :
+        x(array[0]),
+        y(array[1])
+    {
+    }
+
+    TypeT& x;
+    TypeT& y;
+};
+
+template <typename TypeT, size_t SizeT>
+struct LegacyVector : public LegacyElements<TypeT, SizeT>
+{
+    LegacyVector() :
+        LegacyElements<TypeT, SizeT>(mArray)
+    {
+        std::fill(mArray.begin(), mArray.end(), 0);
+    }
+
+    LegacyVector(const LegacyVector<TypeT, SizeT>& other) :
+        LegacyElements<TypeT, SizeT>(mArray)
+    {
+        std::copy(other.mArray.begin(), other.mArray.end(), mArray.begin());
+    }
+
+    LegacyVector(const TypeT& x, const TypeT& y) :
+        LegacyElements<TypeT, SizeT>(mArray)
+    {
+        std::fill(mArray.begin(), mArray.end(), 0);
+        operator[](0) = x;
+        operator[](1) = y;
+    }
+
+    LegacyVector& operator=(const LegacyVector<TypeT, SizeT>& rhs)
+    {
+        mArray = rhs.mArray;
+        return *this;
+    }
+
+    TypeT& operator[](size_t index)
+    {
+        if (index >= SizeT)
+        {
+            throw nyra::core::Exception("Invalid index.");
+        }
+        return mArray[index];
+    }
+
+    const TypeT& operator[](size_t index) const
+    {
+        if (index >= SizeT)
+        {
+            throw nyra::core::Exception("Invalid index.");
+        }
+        return mArray[index];
+    }
+
+    LegacyVector<TypeT, SizeT>& operator+=(
+            const LegacyVector<TypeT, SizeT>& rhs)
+    {
+        for (size_t ii = 0; ii < SizeT; ++ii)
+        {
+            mArray[ii] += rhs[ii];
+        }
+        return *this;
+    }
+
+    LegacyVector<TypeT, SizeT>& operator-=(
+            const LegacyVector<TypeT, SizeT>& rhs)
+    {
+        for (size_t ii = 0; ii < SizeT; ++ii)
+        {
+            mArray[ii] -= rhs[ii];
+        }
+        return *this;
+    }
+
+    LegacyVector<TypeT, SizeT>& operator*=(const TypeT& rhs)
+    {
+        for (size_t ii = 0; ii < SizeT; ++ii)
+        {
+            mArray[ii] *= rhs;
+        }
+        return *this;
+    }
+
+private:
+    std::array<TypeT, SizeT> mArray;
+};
+
+template <typename TypeT, size_t SizeT>
+LegacyVector<TypeT, SizeT> operator+(LegacyVector<TypeT, SizeT> lhs,
+                                     const LegacyVector<TypeT, SizeT>& rhs)
+{
+    lhs += rhs;
+    return lhs;
+}
+
+template <typename TypeT, size_t SizeT>
+LegacyVector<TypeT, SizeT> operator-(LegacyVector<TypeT, SizeT> lhs,
+                                     const LegacyVector<TypeT, SizeT>& rhs)
+{
+    lhs -= rhs;
+    return lhs;
+}
+
+template <typename TypeT, size_t SizeT>
+LegacyVector<TypeT, SizeT> operator*(LegacyVector<TypeT, SizeT> lhs,
+                                     const TypeT& rhs)
+{
+    lhs *= rhs;
+    return lhs;
+}
+
+typedef LegacyVector<float, 2> LegacyVector2F;
+
+/*****************************************************************************/
+// Runs a += b; a *= s over arrays of vectors with the old checked loops,
+// with Vector, and with plain float arrays, which the compiler vectorizes.
+// If Vector keeps up with the plain arrays its loops were vectorized too.
+// The arrays fit in the L2 cache so memory bandwidth does not hide the
+// difference.
+template <size_t SizeT>
+void compareArithmetic()
+{
+    const size_t count = NUM_ARITHMETIC_FLOATS / SizeT;
+    const std::string name = "Vector<float, " + std::to_string(SizeT) + ">";
+    const float scale = 0.5f;
+
+    std::vector<LegacyVector<float, SizeT> > legacyA(count);
+    std::vector<LegacyVector<float, SizeT> > legacyB(count);
+    const double legacy = nyra::benchmark::measure([&]()
+    {
+        for (size_t pass = 0; pass < NUM_ARITHMETIC_PASSES; ++pass)
+        {
+            for (size_t ii = 0; ii < count; ++ii)
+            {
+                legacyA[ii] += legacyB[ii];
+                legacyA[ii] *= scale;
+            }
+        }
+        nyra::benchmark::keep(legacyA.data());
+    });
+    nyra::benchmark::report(name + ", old loops", legacy);
+
+    std::vector<nyra::core::Vector<float, SizeT> > currentA(count);
+    std::vector<nyra::core::Vector<float, SizeT> > currentB(count);
+    const double current = nyra::benchmark::measure([&]()
+    {
+        for (size_t pass = 0; pass < NUM_ARITHMETIC_PASSES; ++pass)
+        {
+            for (size_t ii = 0; ii < count; ++ii)
+            {
+                currentA[ii] += currentB[ii];
+                currentA[ii] *= scale;
+            }
+        }
+        nyra::benchmark::keep(currentA.data());
+    });
+    nyra::benchmark::report(name, current, legacy);
+
+    std::vector<float> plainA(count * SizeT);
+    std::vector<float> plainB(count * SizeT);
+    const double plain = nyra::benchmark::measure([&]()
+    {
+        for (size_t pass = 0; pass < NUM_ARITHMETIC_PASSES; ++pass)
+        {
+            for (size_t ii = 0; ii < plainA.size(); ++ii)
+            {
+                plainA[ii] += plainB[ii];
+                plainA[ii] *= scale;
+            }
+        }
+        nyra::benchmark::keep(plainA.data());
+    });
+    nyra::benchmark::report(name + ", float array", plain, legacy);
+}
+
+/*****************************************************************************/
+// Evaluates out = a + b * s - c with the old operators, which copy a
+// temporary for every operator, and with Vector, which evaluates the
+// whole expression in one loop.
+template <size_t SizeT>
+void compareExpression()
+{
+    const size_t count = NUM_ARITHMETIC_FLOATS / SizeT;
+    const std::string name = "a + b * s - c, Vector<float, " +
+            std::to_string(SizeT) + ">";
+    const float scale = 0.5f;
+
+    std::vector<LegacyVector<float, SizeT> > legacyA(count);
+    std::vector<LegacyVector<float, SizeT> > legacyB(count);
+    std::vector<LegacyVector<float, SizeT> > legacyC(count);
+    std::vector<LegacyVector<float, SizeT> > legacyOut(count);
+    const double legacy = nyra::benchmark::measure([&]()
+    {
+        for (size_t pass = 0; pass < NUM_ARITHMETIC_PASSES; ++pass)
+        {
+            for (size_t ii = 0; ii < count; ++ii)
+            {
+                legacyOut[ii] = legacyA[ii] + legacyB[ii] * scale -
+                                legacyC[ii];
+            }
+        }
+        nyra::benchmark::keep(legacyOut.data());
+    });
+    nyra::benchmark::report(name + ", old operators", legacy);
+
+    std::vector<nyra::core::Vector<float, SizeT> > currentA(count);
+    std::vector<nyra::core::Vector<float, SizeT> > currentB(count);
+    std::vector<nyra::core::Vector<float, SizeT> > currentC(count);
+    std::vector<nyra::core::Vector<float, SizeT> > currentOut(count);
+    const double current = nyra::benchmark::measure([&]()
+    {
+        for (size_t pass = 0; pass < NUM_ARITHMETIC_PASSES; ++pass)
+        {
+            for (size_t ii = 0; ii < count; ++ii)
+            {
+                currentOut[ii] = currentA[ii] + currentB[ii] * scale -
+                                 currentC[ii];
+            }
+        }
+        nyra::benchmark::keep(currentOut.data());
+    });
+    nyra::benchmark::report(name, current, legacy);
+}
+}
+
+namespace nyra
+{
+namespace benchmark
+{
+/*****************************************************************************/
+void runVectorLayout()
+{
+    printf("  sizeof(Vector2F) is %zu bytes, the old layout was %zu\n",
+           sizeof(core::Vector2F),
+           sizeof(LegacyVector2F));
+
+    std::vector<LegacyVector2F> legacy(NUM_VECTORS);
+    std::vector<core::Vector2F> current(NUM_VECTORS);
+    for (size_t ii = 0; ii < NUM_VECTORS; ++ii)
+    {
+        legacy[ii] = LegacyVector2F(static_cast<float>(ii), 1.0f);
+        current[ii] = core::Vector2F(static_cast<float>(ii), 1.0f);
+    }
+
+    const double legacyCopy = measure([&legacy]()
+    {
+        const std::vector<LegacyVector2F> copy(legacy);
+        keep(copy.data());
+    });
+    report("copy 10M, old layout", legacyCopy);
+
+    const double currentCopy = measure([&current]()
+    {
+        const std::vector<core::Vector2F> copy(current);
+        keep(copy.data());
+    });
+    report("copy 10M", currentCopy, legacyCopy);
+
+    float sum = 0.0f;
+    const double legacySum = measure([&legacy, &sum]()
+    {
+        for (size_t ii = 0; ii < legacy.size(); ++ii)
+        {
+            sum += legacy[ii].x * legacy[ii].y;
+        }
+    });
+    report("sum x * y over 10M, old layout", legacySum);
+
+    const double currentSum = measure([&current, &sum]()
+    {
+        for (size_t ii = 0; ii < current.size(); ++ii)
+        {
+            sum += current[ii].x() * current[ii].y();
+        }
+    });
+    report("sum x * y over 10M", currentSum, legacySum);
+    keep(&sum);
+}
+
+/*****************************************************************************/
+void runVectorArithmetic()
+{
+    compareArithmetic<3>();
+    compareArithmetic<4>();
+    compareArithmetic<16>();
+}
+
+/*****************************************************************************/
+void runVectorExpression()
+{
+    compareExpression<3>();
+    compareExpression<4>();
+    compareExpression<16>();
+}
+}
+}
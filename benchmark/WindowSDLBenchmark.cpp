@@ -0,0 +1,92 @@
+/******************************************************************************
+ * The MIT License(MIT)
+ *
+ * Copyright(c) 2015 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+#include <vector>
+#include <graphics/WindowSDL.h>
+#include "Benchmark.h"
+
+namespace
+{
+const size_t WIDTH = 1920;
+const size_t HEIGHT = 1080;
+const size_t NUM_FRAMES = 100;
+}
+
+namespace nyra
+{
+namespace benchmark
+{
+/*****************************************************************************/
+void runWindowSDL()
+{
+    // The dummy driver keeps the window surface in memory so this runs
+    // without a display. Set SDL_VIDEODRIVER=offscreen to use that driver
+    // instead.
+    SDL_setenv("SDL_VIDEODRIVER", "dummy", 0);
+    graphics::WindowSDL window("NyraBenchmark",
+                               core::Vector2UI(WIDTH, HEIGHT),
+                               core::Vector2I(0, 0));
+
+    const std::vector<uint8_t> frame(WIDTH * HEIGHT * 4, 0x80);
+    const graphics::PixelBuffer buffer(&frame[0],
+                                       core::Vector2UI(WIDTH, HEIGHT),
+                                       graphics::BGRA8);
+
+    const double full = measure([&window, &buffer]()
+    {
+        for (size_t ii = 0; ii < NUM_FRAMES; ++ii)
+        {
+            window.showBuffer(buffer);
+        }
+    }) / NUM_FRAMES;
+    report("1080p frame, full present", full);
+
+    graphics::DirtyRegion everything;
+    everything.add(graphics::Rect(0,
+                                  0,
+                                  static_cast<int32_t>(WIDTH),
+                                  static_cast<int32_t>(HEIGHT)));
+    const double whole = measure([&window, &buffer, &everything]()
+    {
+        for (size_t ii = 0; ii < NUM_FRAMES; ++ii)
+        {
+            window.showBuffer(buffer, everything);
+        }
+    }) / NUM_FRAMES;
+    report("1080p frame, whole frame dirty", whole, full);
+
+    // A HUD in one corner and a cursor are all that changed.
+    graphics::DirtyRegion hud;
+    hud.add(graphics::Rect(16, 16, 256, 64));
+    hud.add(graphics::Rect(900, 500, 32, 32));
+    const double partial = measure([&window, &buffer, &hud]()
+    {
+        for (size_t ii = 0; ii < NUM_FRAMES; ++ii)
+        {
+            window.showBuffer(buffer, hud);
+        }
+    }) / NUM_FRAMES;
+    report("1080p frame, HUD and cursor dirty", partial, full);
+}
+}
+}
@@ -0,0 +1,78 @@
+/******************************************************************************
+ * The MIT License(MIT)
+ *
+ * Copyright(c) 2015 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include <exception>
+#include "Benchmark.h"
+
+namespace
+{
+struct Entry
+{
+    const char* name;
+    void (*run)();
+};
+
+const Entry BENCHMARKS[] =
+{
+    {"FileLoader", nyra::benchmark::runFileLoader},
+    {"Matrix", nyra::benchmark::runMatrix},
+    {"Rasterizer", nyra::benchmark::runRasterizer},
+    {"StringConvert", nyra::benchmark::runStringConvert},
+    {"TextureAtlas", nyra::benchmark::runTextureAtlas},
+    {"VectorLayout", nyra::benchmark::runVectorLayout},
+    {"VectorArithmetic", nyra::benchmark::runVectorArithmetic},
+    {"VectorExpression", nyra::benchmark::runVectorExpression},
+    {"WindowSDL", nyra::benchmark::runWindowSDL}
+};
+}
+
+/*****************************************************************************/
+int main(int argc, char** argv)
+{
+    // Run the benchmarks named on the command line, or all of them.
+    try
+    {
+        for (const Entry& entry : BENCHMARKS)
+        {
+            bool selected = argc < 2;
+            for (int ii = 1; ii < argc; ++ii)
+            {
+                selected = selected || !strcmp(argv[ii], entry.name);
+            }
+
+            if (selected)
+            {
+                printf("%s\n", entry.name);
+                entry.run();
+            }
+        }
+    }
+    catch (const std::exception& ex)
+    {
+        fprintf(stderr, "%s\n", ex.what());
+        return 1;
+    }
+    return 0;
+}
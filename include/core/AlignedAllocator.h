@@ -0,0 +1,98 @@
+/******************************************************************************
+ * The MIT License(MIT)
+ *
+ * Copyright(c) 2015 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+#ifndef __NYRA_CORE_ALIGNED_ALLOCATOR_H__
+#define __NYRA_CORE_ALIGNED_ALLOCATOR_H__
+
+#include <stddef.h>
+#include <new>
+#include <limits>
+
+namespace nyra
+{
+namespace core
+{
+/*
+ *  \class AlignedAllocator
+ *  \brief An STL allocator that aligns every allocation. This is used for
+ *         buffers that are processed with SIMD so full width aligned loads
+ *         can be used and cache lines are not split.
+ *
+ *  \param TypeT The type being allocated.
+ *  \param AlignmentT The alignment in bytes. This must be a power of 2.
+ */
+template <typename TypeT, size_t AlignmentT = 64>
+class AlignedAllocator
+{
+public:
+    static_assert((AlignmentT & (AlignmentT - 1)) == 0,
+                  "Alignment must be a power of 2.");
+
+    typedef TypeT value_type;
+
+    template <typename OtherT>
+    struct rebind
+    {
+        typedef AlignedAllocator<OtherT, AlignmentT> other;
+    };
+
+    AlignedAllocator()
+    {
+    }
+
+    template <typename OtherT>
+    AlignedAllocator(const AlignedAllocator<OtherT, AlignmentT>&)
+    {
+    }
+
+    TypeT* allocate(size_t count)
+    {
+        if (count > std::numeric_limits<size_t>::max() / sizeof(TypeT))
+        {
+            throw std::bad_alloc();
+        }
+        return static_cast<TypeT*>(::operator new(
+                count * sizeof(TypeT), std::align_val_t(AlignmentT)));
+    }
+
+    void deallocate(TypeT* pointer, size_t)
+    {
+        ::operator delete(pointer, std::align_val_t(AlignmentT));
+    }
+
+    template <typename OtherT>
+    bool operator==(const AlignedAllocator<OtherT, AlignmentT>&) const
+    {
+        return true;
+    }
+
+    template <typename OtherT>
+    bool operator!=(const AlignedAllocator<OtherT, AlignmentT>&) const
+    {
+        return false;
+    }
+};
+}
+}
+
+#endif
@@ -0,0 +1,157 @@
+/******************************************************************************
+ * The MIT License(MIT)
+ *
+ * Copyright(c) 2015 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+#ifndef __NYRA_CORE_BOUNDS_H__
+#define __NYRA_CORE_BOUNDS_H__
+
+#include <limits>
+#include <core/Vector.h>
+
+namespace nyra
+{
+namespace core
+{
+/*
+ *  \class Bounds
+ *  \brief An axis aligned bounding box that includes both corners. A
+ *         default constructed box is empty: minimum is larger than maximum
+ *         so expanding it by anything gives that thing's bounds.
+ */
+template <typename TypeT, size_t SizeT>
+struct Bounds
+{
+    typedef Vector<TypeT, SizeT> VectorT;
+
+    constexpr Bounds() :
+        minimum(),
+        maximum()
+    {
+        for (size_t ii = 0; ii < SizeT; ++ii)
+        {
+            minimum.data()[ii] = std::numeric_limits<TypeT>::max();
+            maximum.data()[ii] = std::numeric_limits<TypeT>::lowest();
+        }
+    }
+
+    constexpr Bounds(const VectorT& low, const VectorT& high) :
+        minimum(low),
+        maximum(high)
+    {
+    }
+
+    /*
+     *  \func isEmpty
+     *  \brief Checks if the box contains nothing.
+     */
+    constexpr bool isEmpty() const
+    {
+        for (size_t ii = 0; ii < SizeT; ++ii)
+        {
+            if (minimum.data()[ii] > maximum.data()[ii])
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    constexpr bool contains(const VectorT& point) const
+    {
+        for (size_t ii = 0; ii < SizeT; ++ii)
+        {
+            if (point.data()[ii] < minimum.data()[ii] ||
+                point.data()[ii] > maximum.data()[ii])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    constexpr bool contains(const Bounds& other) const
+    {
+        return contains(other.minimum) && contains(other.maximum);
+    }
+
+    constexpr bool intersects(const Bounds& other) const
+    {
+        for (size_t ii = 0; ii < SizeT; ++ii)
+        {
+            if (other.maximum.data()[ii] < minimum.data()[ii] ||
+                other.minimum.data()[ii] > maximum.data()[ii])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    constexpr Bounds& expand(const VectorT& point)
+    {
+        minimum.minimize(point);
+        maximum.maximize(point);
+        return *this;
+    }
+
+    constexpr Bounds& expand(const Bounds& other)
+    {
+        minimum.minimize(other.minimum);
+        maximum.maximize(other.maximum);
+        return *this;
+    }
+
+    /*
+     *  \func distanceSquared
+     *  \brief Gets the squared distance from a point to the closest point
+     *         in the box. This is 0 for points inside the box.
+     */
+    constexpr TypeT distanceSquared(const VectorT& point) const
+    {
+        TypeT ret = static_cast<TypeT>(0);
+        for (size_t ii = 0; ii < SizeT; ++ii)
+        {
+            const TypeT value = point.data()[ii];
+            TypeT delta = static_cast<TypeT>(0);
+            if (value < minimum.data()[ii])
+            {
+                delta = minimum.data()[ii] - value;
+            }
+            else if (value > maximum.data()[ii])
+            {
+                delta = value - maximum.data()[ii];
+            }
+            ret += delta * delta;
+        }
+        return ret;
+    }
+
+    VectorT minimum;
+    VectorT maximum;
+};
+
+typedef Bounds<float, 2> Bounds2F;
+typedef Bounds<float, 3> Bounds3F;
+}
+}
+
+#endif
@@ -0,0 +1,139 @@
+/******************************************************************************
+ * The MIT License(MIT)
+ *
+ * Copyright(c) 2015 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+#ifndef __NYRA_CORE_COLUMN_CONVERT_H__
+#define __NYRA_CORE_COLUMN_CONVERT_H__
+
+#include <vector>
+#include <mutex>
+#include <memory>
+#include <string_view>
+#include <algorithm>
+#include <type_traits>
+#include <core/StringConvert.h>
+#include <core/ThreadPool.h>
+
+namespace nyra
+{
+namespace core
+{
+/*
+ *  \func toColumn
+ *  \brief Converts a column of tokens, such as the output of split, into
+ *         values in one pass. Unlike toType this does not stop at the
+ *         first bad token. Every token that fails to convert is reported
+ *         by index and its value is set to T().
+ *
+ *  \param tokens The strings to convert.
+ *  \param count The number of tokens.
+ *  \param out [OUTPUT] The converted values. This must hold count values.
+ *  \param errors [OUTPUT] The indices of the tokens that failed, in
+ *                increasing order. Indices are appended, errors is not
+ *                cleared.
+ *  \param pool Optional workers used to convert large columns in
+ *              parallel.
+ *  \return The number of tokens that failed to convert.
+ */
+template<typename T> size_t toColumn(const std::string_view* tokens,
+                                     size_t count,
+                                     T* out,
+                                     std::vector<size_t>& errors,
+                                     ThreadPool* pool = nullptr)
+{
+    const size_t startErrors = errors.size();
+    std::mutex mutex;
+
+    auto convert = [&](size_t begin, size_t end)
+    {
+        std::vector<size_t> chunkErrors;
+        for (size_t ii = begin; ii < end; ++ii)
+        {
+            if (!tryToType(tokens[ii], out[ii]))
+            {
+                out[ii] = T();
+                chunkErrors.push_back(ii);
+            }
+        }
+
+        if (!chunkErrors.empty())
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            errors.insert(errors.end(), chunkErrors.begin(), chunkErrors.end());
+        }
+    };
+
+    if (pool)
+    {
+        pool->parallelFor(count, 16384, convert);
+
+        // Chunks can finish in any order.
+        std::sort(errors.begin() + startErrors, errors.end());
+    }
+    else
+    {
+        convert(0, count);
+    }
+
+    return errors.size() - startErrors;
+}
+
+/*
+ *  \func toColumn
+ *  \brief Converts a column of tokens, such as the output of split, into
+ *         a contiguous vector of values. Every token that fails to convert
+ *         is reported by index and its value is set to T().
+ *
+ *  \param tokens The strings to convert.
+ *  \param errors [OUTPUT] The indices of the tokens that failed, in
+ *                increasing order. Indices are appended, errors is not
+ *                cleared.
+ *  \param pool Optional workers used to convert large columns in
+ *              parallel.
+ *  \return The converted values, one per token.
+ */
+template<typename T> std::vector<T> toColumn(
+        const std::vector<std::string_view>& tokens,
+        std::vector<size_t>& errors,
+        ThreadPool* pool = nullptr)
+{
+    if constexpr (std::is_same<T, bool>::value)
+    {
+        // std::vector<bool> packs its bits so it has no data to write to.
+        std::unique_ptr<bool[]> values(new bool[tokens.size()]);
+        toColumn(tokens.data(), tokens.size(), values.get(), errors, pool);
+        return std::vector<bool>(values.get(), values.get() + tokens.size());
+    }
+    else
+    {
+        std::vector<T> ret(tokens.size());
+        if (!tokens.empty())
+        {
+            toColumn(tokens.data(), tokens.size(), ret.data(), errors, pool);
+        }
+        return ret;
+    }
+}
+}
+}
+
+#endif
@@ -62,7 +62,7 @@ public:
      *         internally by the exception object and should not be modified
      *         or freed externally.
      */
-    virtual const char* what() const
+    virtual const char* what() const noexcept
     {
         return mMessage.c_str();
     }
@@ -68,6 +68,168 @@ std::string readFile(const std::string& pathname);
  *  \throw - If the file fails to open.
  */
 std::vector<uint8_t> readBinary(const std::string& pathname);
+
+/*
+ *  \func - getPageSize
+ *  \brief - Gets the size of a virtual memory page in bytes. Mapped files
+ *           are loaded and advised in units of this size.
+ */
+size_t getPageSize();
+
+/*
+ *  \class MappedFile
+ *  \brief Provides read-only, zero-copy access to a file by mapping it
+ *         into the address space of the process. Pages are loaded from
+ *         the page cache on demand so large files can be parsed in place
+ *         without first being copied into a buffer. The mapping is
+ *         released when the object is destroyed.
+ */
+class MappedFile
+{
+public:
+    /*
+     *  \enum Advice
+     *  \brief Hints to the operating system about how the mapped memory
+     *         is going to be accessed.
+     *
+     *  \value NORMAL - No special treatment.
+     *  \value SEQUENTIAL - The file will be read from front to back so
+     *         pages can be read ahead aggressively and dropped once used.
+     *  \value RANDOM - Pages will be accessed in no particular order so
+     *         read ahead should be disabled.
+     *  \value WILL_NEED - The data will be needed soon so it should be
+     *         loaded into memory now.
+     */
+    enum Advice
+    {
+        NORMAL,
+        SEQUENTIAL,
+        RANDOM,
+        WILL_NEED
+    };
+
+    /*
+     *  \func Constructor
+     *  \brief Creates an empty mapping. Call open to map a file.
+     */
+    MappedFile();
+
+    /*
+     *  \func Constructor
+     *  \brief Maps an entire file into memory.
+     *
+     *  \param pathname - The pathname to the file on disk. This can be
+     *         relative or absolute.
+     *  \param advice - The expected access pattern.
+     *  \throw - If the file fails to open or cannot be mapped.
+     */
+    explicit MappedFile(const std::string& pathname,
+                        Advice advice = NORMAL);
+
+    /*
+     *  \func Constructor (move)
+     *  \brief Takes ownership of another mapping. The other object is left
+     *         empty.
+     */
+    MappedFile(MappedFile&& other);
+
+    /*
+     *  \func Destructor
+     *  \brief Unmaps the file.
+     */
+    ~MappedFile();
+
+    /*
+     *  \func Assignment (move)
+     *  \brief Releases the current mapping and takes ownership of another.
+     */
+    MappedFile& operator=(MappedFile&& other);
+
+    /*
+     *  \func - open
+     *  \brief - Maps an entire file into memory. Any existing mapping is
+     *           released first.
+     *
+     *  \param pathname - The pathname to the file on disk. This can be
+     *         relative or absolute.
+     *  \param advice - The expected access pattern.
+     *  \throw - If the file fails to open or cannot be mapped.
+     */
+    void open(const std::string& pathname,
+              Advice advice = NORMAL);
+
+    /*
+     *  \func - close
+     *  \brief - Unmaps the file. This is safe to call on an empty mapping.
+     */
+    void close();
+
+    /*
+     *  \func - advise
+     *  \brief - Changes the expected access pattern of the whole mapping.
+     *
+     *  \param advice - The expected access pattern.
+     */
+    void advise(Advice advice);
+
+    /*
+     *  \func - advise
+     *  \brief - Changes the expected access pattern for part of the
+     *           mapping. This is useful to prefetch a region before it is
+     *           parsed.
+     *
+     *  \param advice - The expected access pattern.
+     *  \param offset - The byte offset into the file.
+     *  \param size - The number of bytes the advice applies to. This is
+     *         clamped to the end of the file.
+     */
+    void advise(Advice advice, size_t offset, size_t size);
+
+    /*
+     *  \func - data
+     *  \brief - Gets the start of the mapped file. This is nullptr if
+     *           nothing is mapped or the file is empty.
+     */
+    const uint8_t* data() const
+    {
+        return mData;
+    }
+
+    /*
+     *  \func - size
+     *  \brief - Gets the number of mapped bytes.
+     */
+    size_t size() const
+    {
+        return mSize;
+    }
+
+    /*
+     *  \func - empty
+     *  \brief - Checks if there are any mapped bytes.
+     */
+    bool empty() const
+    {
+        return mSize == 0;
+    }
+
+    const uint8_t* begin() const
+    {
+        return mData;
+    }
+
+    const uint8_t* end() const
+    {
+        return mData + mSize;
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+private:
+    const uint8_t* mData;
+    size_t mSize;
+};
 }
 }
 
@@ -0,0 +1,123 @@
+/******************************************************************************
+ * The MIT License(MIT)
+ *
+ * Copyright(c) 2015 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+#ifndef __NYRA_CORE_FILE_LOADER_H__
+#define __NYRA_CORE_FILE_LOADER_H__
+
+#include <stdint.h>
+#include <vector>
+#include <string>
+#include <future>
+#include <chrono>
+#include <core/ThreadPool.h>
+
+namespace nyra
+{
+namespace core
+{
+/*
+ *  \class FileLoader
+ *  \brief Loads files on background threads so the caller never blocks on
+ *         disk I/O. Many requests can be queued at once and their reads
+ *         overlap across the worker threads. Results are returned through
+ *         futures which can be polled from a frame loop with isReady.
+ */
+class FileLoader
+{
+public:
+    typedef std::vector<uint8_t> Buffer;
+
+    /*
+     *  \func Constructor
+     *  \brief Starts the worker threads.
+     *
+     *  \param numThreads - The number of files that can be read at the same
+     *         time. Passing 0 uses the number of hardware threads.
+     */
+    explicit FileLoader(size_t numThreads = 0);
+
+    /*
+     *  \func - load
+     *  \brief - Queues a file to be read with readBinary.
+     *
+     *  \param pathname - The pathname to the file on disk. This can be
+     *         relative or absolute.
+     *  \return - A future holding the contents of the file. If the file
+     *            fails to open, future::get throws.
+     */
+    std::future<Buffer> load(const std::string& pathname);
+
+    /*
+     *  \func - load
+     *  \brief - Queues a batch of files to be read with readBinary.
+     *
+     *  \param pathnames - The pathnames of the files on disk.
+     *  \return - One future per file, in the same order as pathnames.
+     */
+    std::vector<std::future<Buffer> > load(
+            const std::vector<std::string>& pathnames);
+
+    /*
+     *  \func - prefetch
+     *  \brief - Queues a file to be pulled into the operating system's page
+     *           cache without keeping a copy of it. A later call to
+     *           readBinary, load or MappedFile on the same file is then
+     *           served from memory instead of disk. Errors are ignored.
+     *
+     *  \param pathname - The pathname to the file on disk. This can be
+     *         relative or absolute.
+     */
+    void prefetch(const std::string& pathname);
+
+    /*
+     *  \func - getNumPending
+     *  \brief - Gets the number of requests that have not started yet.
+     */
+    size_t getNumPending()
+    {
+        return mPool.getNumPending();
+    }
+
+    /*
+     *  \func - isReady
+     *  \brief - Checks if a future has a result without blocking. This is
+     *           meant to be called once per frame.
+     *
+     *  \param future - The future to check.
+     *  \return - True if get can be called without waiting.
+     */
+    template <typename T>
+    static bool isReady(const std::future<T>& future)
+    {
+        return future.valid() &&
+               future.wait_for(std::chrono::seconds(0)) ==
+                       std::future_status::ready;
+    }
+
+private:
+    ThreadPool mPool;
+};
+}
+}
+
+#endif
@@ -0,0 +1,158 @@
+/******************************************************************************
+ * The MIT License(MIT)
+ *
+ * Copyright(c) 2015 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+#ifndef __NYRA_CORE_FILE_READER_H__
+#define __NYRA_CORE_FILE_READER_H__
+
+#include <stdint.h>
+#include <string>
+#include <fstream>
+
+namespace nyra
+{
+namespace core
+{
+/*
+ *  \class FileReader
+ *  \brief Streams a file from disk in pieces. Data is read directly into
+ *         buffers owned by the caller so the memory used does not depend
+ *         on the size of the file. This should be preferred over readFile
+ *         and readBinary for very large files.
+ */
+class FileReader
+{
+public:
+    /*
+     *  \func Constructor
+     *  \brief Creates a reader that is not attached to a file. Call open
+     *         before reading.
+     */
+    FileReader();
+
+    /*
+     *  \func Constructor
+     *  \brief Opens a file for reading.
+     *
+     *  \param pathname - The pathname to the file on disk. This can be
+     *         relative or absolute.
+     *  \throw - If the file fails to open.
+     */
+    explicit FileReader(const std::string& pathname);
+
+    /*
+     *  \func - open
+     *  \brief - Opens a file for reading. Any open file is closed first.
+     *
+     *  \param pathname - The pathname to the file on disk. This can be
+     *         relative or absolute.
+     *  \throw - If the file fails to open.
+     */
+    void open(const std::string& pathname);
+
+    /*
+     *  \func - close
+     *  \brief - Closes the file.
+     */
+    void close();
+
+    /*
+     *  \func - isOpen
+     *  \brief - Checks if a file is currently open.
+     */
+    bool isOpen() const
+    {
+        return mStream.is_open();
+    }
+
+    /*
+     *  \func - read
+     *  \brief - Reads the next chunk of the file into a buffer. Nothing is
+     *           allocated so the same buffer can be reused for every call.
+     *
+     *  \param buffer [OUTPUT] - The buffer to fill.
+     *  \param size - The maximum number of bytes to read.
+     *  \return - The number of bytes read. This is only less than size
+     *            when the end of the file is reached.
+     *  \throw - If no file is open.
+     */
+    size_t read(void* buffer, size_t size);
+
+    /*
+     *  \func - readLine
+     *  \brief - Reads the next line of the file. The line terminator
+     *           (\n or \r\n) is not included. The capacity of line is
+     *           reused so iterating over a file does not allocate once the
+     *           longest line has been seen.
+     *
+     *  \param line [OUTPUT] - The contents of the line.
+     *  \return - False once there are no more lines.
+     *  \throw - If no file is open.
+     */
+    bool readLine(std::string& line);
+
+    /*
+     *  \func - seek
+     *  \brief - Moves the read position. Seeking clears the end of file
+     *           state.
+     *
+     *  \param offset - The byte offset from the start of the file.
+     *  \throw - If no file is open or the offset is past the end of the
+     *           file.
+     */
+    void seek(uint64_t offset);
+
+    /*
+     *  \func - tell
+     *  \brief - Gets the current read position in bytes.
+     */
+    uint64_t tell();
+
+    /*
+     *  \func - size
+     *  \brief - Gets the size of the file in bytes.
+     */
+    uint64_t size() const
+    {
+        return mSize;
+    }
+
+    /*
+     *  \func - eof
+     *  \brief - Checks if the end of the file has been reached.
+     */
+    bool eof() const
+    {
+        return !mStream.is_open() || mStream.eof();
+    }
+
+private:
+    void checkOpen() const;
+
+    std::ifstream mStream;
+    std::string mPathname;
+    uint64_t mSize;
+};
+}
+}
+
+#endif
@@ -0,0 +1,205 @@
+/******************************************************************************
+ * The MIT License(MIT)
+ *
+ * Copyright(c) 2015 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+#ifndef __NYRA_CORE_KD_TREE_H__
+#define __NYRA_CORE_KD_TREE_H__
+
+#include <stdint.h>
+#include <vector>
+#include <core/Vector.h>
+#include <core/Bounds.h>
+#include <core/ThreadPool.h>
+
+namespace nyra
+{
+namespace core
+{
+/*
+ *  \class KdTree
+ *  \brief A bounding volume hierarchy over 2D points for proximity queries
+ *         on data that rarely changes. The tree is built in one pass by
+ *         splitting the points at the median of their widest axis, so it
+ *         is always balanced. Every node keeps the tight bounds of its
+ *         points, which lets queries skip whole subtrees.
+ *
+ *         Points are identified by their index in the array the tree was
+ *         built from. Points can be moved with setPosition followed by
+ *         refit. This keeps queries correct but they slow down as points
+ *         drift away from where the tree was built, so rebuild after large
+ *         changes.
+ */
+class KdTree
+{
+public:
+    typedef uint32_t Id;
+
+    /*
+     *  \func Constructor
+     *  \brief Creates an empty tree.
+     */
+    KdTree();
+
+    /*
+     *  \func build
+     *  \brief Replaces the contents of the tree.
+     *
+     *  \param positions The points to add. The id of each point is its
+     *                   index.
+     *  \param count The number of points.
+     *  \param pool Optional workers used to build separate subtrees in
+     *              parallel.
+     *  \throw Exception if there are too many points for an Id.
+     */
+    void build(const Vector2F* positions,
+               size_t count,
+               ThreadPool* pool = nullptr);
+
+    void build(const std::vector<Vector2F>& positions,
+               ThreadPool* pool = nullptr)
+    {
+        build(positions.data(), positions.size(), pool);
+    }
+
+    /*
+     *  \func setPosition
+     *  \brief Moves a point. refit must be called before the next query.
+     *
+     *  \throw Exception if the id is out of range.
+     */
+    void setPosition(Id id, const Vector2F& position);
+
+    /*
+     *  \func refit
+     *  \brief Recomputes the bounds of every node after points have moved.
+     *
+     *  \param pool Optional workers used to split the work.
+     */
+    void refit(ThreadPool* pool = nullptr);
+
+    /*
+     *  \func getPosition
+     *  \brief Gets the position of a point.
+     *
+     *  \throw Exception if the id is out of range.
+     */
+    const Vector2F& getPosition(Id id) const;
+
+    /*
+     *  \func getBounds
+     *  \brief Gets the bounds of every point. This is empty for an empty
+     *         tree.
+     */
+    Bounds2F getBounds() const
+    {
+        return mNodes.empty() ? Bounds2F() : mNodes[0].bounds;
+    }
+
+    size_t size() const
+    {
+        return mItems.size();
+    }
+
+    bool empty() const
+    {
+        return mItems.empty();
+    }
+
+    /*
+     *  \func queryRadius
+     *  \brief Finds every point within a distance of center, including
+     *         points exactly radius away. Results are in no particular
+     *         order.
+     *
+     *  \param out [OUTPUT] The ids of the points. Ids are appended, out is
+     *             not cleared.
+     */
+    void queryRadius(const Vector2F& center,
+                     float radius,
+                     std::vector<Id>& out) const;
+
+    /*
+     *  \func queryBounds
+     *  \brief Finds every point inside a box, including its edges. Results
+     *         are in no particular order.
+     *
+     *  \param out [OUTPUT] The ids of the points. Ids are appended, out is
+     *             not cleared.
+     */
+    void queryBounds(const Bounds2F& bounds, std::vector<Id>& out) const;
+
+    /*
+     *  \func queryNearest
+     *  \brief Finds the points closest to center.
+     *
+     *  \param count The number of points to find. Fewer are returned if
+     *               the tree holds fewer points.
+     *  \param out [OUTPUT] The ids of the points, nearest first. Ids are
+     *             appended, out is not cleared.
+     */
+    void queryNearest(const Vector2F& center,
+                      size_t count,
+                      std::vector<Id>& out) const;
+
+private:
+    struct Item
+    {
+        Vector2F position;
+        Id id;
+    };
+
+    /*
+     *  The tree is stored implicitly: the children of node n are 2n + 1
+     *  and 2n + 2, and a node with LEAF_SIZE points or fewer is a leaf. The
+     *  shape only depends on the number of points so separate subtrees can
+     *  be built at the same time without coordinating.
+     */
+    struct Node
+    {
+        Bounds2F bounds;
+        uint32_t begin;
+        uint32_t end;
+    };
+
+    static const size_t LEAF_SIZE = 8;
+
+    static bool isLeaf(const Node& node)
+    {
+        return node.end - node.begin <= LEAF_SIZE;
+    }
+
+    static size_t countNodes(size_t index, size_t count);
+
+    void splitNode(size_t index, size_t begin, size_t end);
+
+    void buildNode(size_t index, size_t begin, size_t end);
+
+    void refitLeaf(Node& node);
+
+    std::vector<Item> mItems;
+    std::vector<Node> mNodes;
+    std::vector<uint32_t> mSlots;
+};
+}
+}
+
+#endif
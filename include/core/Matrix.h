@@ -0,0 +1,658 @@
+/******************************************************************************
+ * The MIT License(MIT)
+ *
+ * Copyright(c) 2015 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+#ifndef __NYRA_CORE_MATRIX_H__
+#define __NYRA_CORE_MATRIX_H__
+
+#include <ostream>
+#include <array>
+#include <type_traits>
+#include <core/Vector.h>
+#include <core/MatrixKernels.h>
+#include <core/ThreadPool.h>
+#include <core/Exception.h>
+
+namespace nyra
+{
+namespace core
+{
+/*
+ *  \class Matrix
+ *  \brief A fixed size matrix with RowsT rows and ColsT columns. The
+ *         elements are stored contiguously column by column with nothing
+ *         else, so a matrix or an array of them can be handed to graphics
+ *         APIs directly. Vectors are treated as columns, so
+ *         transforms are applied as matrix * vector and combined right to
+ *         left. Square float matrices up to 4x4 use SSE at runtime. Every
+ *         operation except the array transforms can be evaluated at
+ *         compile time.
+ */
+template <typename TypeT, size_t RowsT, size_t ColsT>
+struct Matrix
+{
+    typedef TypeT Type;
+    typedef Vector<TypeT, RowsT> ColumnT;
+    typedef Vector<TypeT, ColsT> RowT;
+
+    /*
+     *  \func Constructor
+     *  \brief Creates a matrix of zeros.
+     */
+    constexpr Matrix() :
+        mValues()
+    {
+    }
+
+    template <typename OtherT>
+    constexpr Matrix(const Matrix<OtherT, RowsT, ColsT>& other) :
+        mValues()
+    {
+        for (size_t ii = 0; ii < RowsT * ColsT; ++ii)
+        {
+            mValues[ii] = static_cast<TypeT>(other.data()[ii]);
+        }
+    }
+
+    /*
+     *  \func Constructor
+     *  \brief Creates a matrix from every element listed row by row, the
+     *         way the matrix is normally written out.
+     */
+    template <typename... ValuesT, typename = typename std::enable_if<
+            sizeof...(ValuesT) == RowsT * ColsT &&
+            (RowsT * ColsT > 1)>::type>
+    constexpr Matrix(const ValuesT&... values) :
+        mValues()
+    {
+        const TypeT rowMajor[] = {static_cast<TypeT>(values)...};
+        for (size_t row = 0; row < RowsT; ++row)
+        {
+            for (size_t col = 0; col < ColsT; ++col)
+            {
+                at(row, col) = rowMajor[row * ColsT + col];
+            }
+        }
+    }
+
+    /*
+     *  \func identity
+     *  \brief Creates a matrix with ones on the diagonal.
+     */
+    static constexpr Matrix identity()
+    {
+        Matrix ret;
+        for (size_t ii = 0; ii < RowsT && ii < ColsT; ++ii)
+        {
+            ret.at(ii, ii) = static_cast<TypeT>(1);
+        }
+        return ret;
+    }
+
+    /*
+     *  \func translation
+     *  \brief Creates an affine transform that moves points by offset.
+     */
+    static constexpr Matrix translation(const Vector<TypeT, RowsT - 1>& offset)
+    {
+        static_assert(RowsT == ColsT, "Translations must be square.");
+        Matrix ret = identity();
+        for (size_t row = 0; row + 1 < RowsT; ++row)
+        {
+            ret.at(row, ColsT - 1) = offset.data()[row];
+        }
+        return ret;
+    }
+
+    /*
+     *  \func scaling
+     *  \brief Creates an affine transform that scales each axis.
+     */
+    static constexpr Matrix scaling(const Vector<TypeT, RowsT - 1>& scale)
+    {
+        static_assert(RowsT == ColsT, "Scales must be square.");
+        Matrix ret = identity();
+        for (size_t row = 0; row + 1 < RowsT; ++row)
+        {
+            ret.at(row, row) = scale.data()[row];
+        }
+        return ret;
+    }
+
+    /*
+     *  \func fromColumns
+     *  \brief Creates a matrix from its columns.
+     */
+    static constexpr Matrix fromColumns(
+            const std::array<ColumnT, ColsT>& columns)
+    {
+        Matrix ret;
+        for (size_t col = 0; col < ColsT; ++col)
+        {
+            ret.setColumn(col, columns[col]);
+        }
+        return ret;
+    }
+
+    /*
+     *  \func fromRows
+     *  \brief Creates a matrix from its rows.
+     */
+    static constexpr Matrix fromRows(const std::array<RowT, RowsT>& rows)
+    {
+        Matrix ret;
+        for (size_t row = 0; row < RowsT; ++row)
+        {
+            ret.setRow(row, rows[row]);
+        }
+        return ret;
+    }
+
+    /*
+     *  \func operator()
+     *  \brief Accesses an element.
+     *
+     *  \throw Exception if either index is out of range.
+     */
+    constexpr TypeT& operator()(size_t row, size_t col)
+    {
+        checkIndex(row, col);
+        return at(row, col);
+    }
+
+    constexpr const TypeT& operator()(size_t row, size_t col) const
+    {
+        checkIndex(row, col);
+        return at(row, col);
+    }
+
+    /*
+     *  \func get
+     *  \brief Accesses an element with indices that are checked at
+     *         compile time.
+     */
+    template <size_t RowT, size_t ColT>
+    constexpr TypeT& get()
+    {
+        static_assert(RowT < RowsT && ColT < ColsT, "Invalid index.");
+        return at(RowT, ColT);
+    }
+
+    template <size_t RowT, size_t ColT>
+    constexpr const TypeT& get() const
+    {
+        static_assert(RowT < RowsT && ColT < ColsT, "Invalid index.");
+        return at(RowT, ColT);
+    }
+
+    /*
+     *  \func getColumn
+     *  \brief Copies a column out of the matrix.
+     *
+     *  \throw Exception if the index is out of range.
+     */
+    constexpr ColumnT getColumn(size_t col) const
+    {
+        checkIndex(0, col);
+        ColumnT ret;
+        for (size_t row = 0; row < RowsT; ++row)
+        {
+            ret.data()[row] = at(row, col);
+        }
+        return ret;
+    }
+
+    /*
+     *  \func setColumn
+     *  \brief Copies values into a column of the matrix.
+     *
+     *  \throw Exception if the index is out of range.
+     */
+    constexpr void setColumn(size_t col, const ColumnT& values)
+    {
+        checkIndex(0, col);
+        for (size_t row = 0; row < RowsT; ++row)
+        {
+            at(row, col) = values.data()[row];
+        }
+    }
+
+    /*
+     *  \func getRow
+     *  \brief Copies a row out of the matrix.
+     *
+     *  \throw Exception if the index is out of range.
+     */
+    constexpr RowT getRow(size_t row) const
+    {
+        checkIndex(row, 0);
+        RowT ret;
+        for (size_t col = 0; col < ColsT; ++col)
+        {
+            ret.data()[col] = at(row, col);
+        }
+        return ret;
+    }
+
+    /*
+     *  \func setRow
+     *  \brief Copies values into a row of the matrix.
+     *
+     *  \throw Exception if the index is out of range.
+     */
+    constexpr void setRow(size_t row, const RowT& values)
+    {
+        checkIndex(row, 0);
+        for (size_t col = 0; col < ColsT; ++col)
+        {
+            at(row, col) = values.data()[col];
+        }
+    }
+
+    /*
+     *  \func data
+     *  \brief Gets a pointer to the elements, stored column by column.
+     */
+    constexpr TypeT* data()
+    {
+        return mValues.data();
+    }
+
+    constexpr const TypeT* data() const
+    {
+        return mValues.data();
+    }
+
+    constexpr bool operator==(const Matrix& rhs) const
+    {
+        for (size_t ii = 0; ii < RowsT * ColsT; ++ii)
+        {
+            if (mValues[ii] != rhs.mValues[ii])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    constexpr bool operator!=(const Matrix& rhs) const
+    {
+        return !operator==(rhs);
+    }
+
+    constexpr Matrix& operator+=(const Matrix& rhs)
+    {
+        VectorKernels<TypeT, RowsT * ColsT>::add(mValues.data(),
+                                                 rhs.mValues.data());
+        return *this;
+    }
+
+    constexpr Matrix& operator-=(const Matrix& rhs)
+    {
+        VectorKernels<TypeT, RowsT * ColsT>::subtract(mValues.data(),
+                                                      rhs.mValues.data());
+        return *this;
+    }
+
+    template <typename ScalarT, typename = typename std::enable_if<
+            IsVectorScalar<ScalarT>::value>::type>
+    constexpr Matrix& operator*=(const ScalarT& rhs)
+    {
+        for (size_t ii = 0; ii < RowsT * ColsT; ++ii)
+        {
+            mValues[ii] *= rhs;
+        }
+        return *this;
+    }
+
+    /*
+     *  \func operator*=
+     *  \brief Multiplies by another square matrix on the right.
+     */
+    constexpr Matrix& operator*=(const Matrix& rhs)
+    {
+        static_assert(RowsT == ColsT, "Only square matrices can be "
+                      "multiplied in place.");
+        *this = *this * rhs;
+        return *this;
+    }
+
+    /*
+     *  \func transpose
+     *  \brief Gets the matrix with its rows and columns swapped.
+     */
+    constexpr Matrix<TypeT, ColsT, RowsT> transpose() const
+    {
+        Matrix<TypeT, ColsT, RowsT> ret;
+        if constexpr (RowsT == ColsT)
+        {
+            MatrixKernels<TypeT, RowsT>::transpose(data(), ret.data());
+        }
+        else
+        {
+            for (size_t col = 0; col < ColsT; ++col)
+            {
+                for (size_t row = 0; row < RowsT; ++row)
+                {
+                    ret.data()[row * ColsT + col] = at(row, col);
+                }
+            }
+        }
+        return ret;
+    }
+
+    /*
+     *  \func determinant
+     *  \brief Computes the determinant of a square matrix.
+     */
+    constexpr TypeT determinant() const
+    {
+        static_assert(RowsT == ColsT,
+                      "Only square matrices have a determinant.");
+        return MatrixKernels<TypeT, RowsT>::determinant(data());
+    }
+
+    /*
+     *  \func inverse
+     *  \brief Computes the inverse of a square matrix.
+     *
+     *  \throw Exception if the matrix is singular.
+     */
+    constexpr Matrix inverse() const
+    {
+        Matrix ret;
+        if (!tryInverse(ret))
+        {
+            throw core::Exception("Matrix is singular.");
+        }
+        return ret;
+    }
+
+    /*
+     *  \func tryInverse
+     *  \brief Computes the inverse of a square matrix without throwing.
+     *
+     *  \param out [OUTPUT] The inverse. This is unspecified on failure.
+     *  \return false if the matrix is singular.
+     */
+    constexpr bool tryInverse(Matrix& out) const
+    {
+        static_assert(RowsT == ColsT, "Only square matrices can be inverted.");
+        static_assert(std::is_floating_point<TypeT>::value,
+                      "Only floating point matrices can be inverted.");
+        if (&out == this)
+        {
+            Matrix copy(*this);
+            return copy.tryInverse(out);
+        }
+        return MatrixKernels<TypeT, RowsT>::inverse(data(), out.data());
+    }
+
+    /*
+     *  \func transformPoint
+     *  \brief Transforms a point that has one less element than the
+     *         matrix is wide, treating the missing element as 1. The last
+     *         row is ignored, so this is for affine transforms such as a
+     *         Matrix3F applied to a Vector2F.
+     */
+    constexpr Vector<TypeT, ColsT - 1> transformPoint(
+            const Vector<TypeT, ColsT - 1>& point) const
+    {
+        static_assert(RowsT == ColsT,
+                      "Only square matrices can transform points.");
+        Vector<TypeT, ColsT - 1> ret;
+        MatrixKernels<TypeT, RowsT>::transformPoint(data(), point.data(),
+                                                    ret.data());
+        return ret;
+    }
+
+private:
+    template <typename, size_t, size_t>
+    friend struct Matrix;
+
+    constexpr void checkIndex(size_t row, size_t col) const
+    {
+        if (row >= RowsT || col >= ColsT)
+        {
+            throw core::Exception("Invalid index.");
+        }
+    }
+
+    constexpr TypeT& at(size_t row, size_t col)
+    {
+        return mValues[col * RowsT + row];
+    }
+
+    constexpr const TypeT& at(size_t row, size_t col) const
+    {
+        return mValues[col * RowsT + row];
+    }
+
+    std::array<TypeT, RowsT * ColsT> mValues;
+};
+
+template <typename TypeT, size_t RowsT, size_t ColsT>
+constexpr Matrix<TypeT, RowsT, ColsT> operator+(
+        Matrix<TypeT, RowsT, ColsT> lhs,
+        const Matrix<TypeT, RowsT, ColsT>& rhs)
+{
+    return lhs += rhs;
+}
+
+template <typename TypeT, size_t RowsT, size_t ColsT>
+constexpr Matrix<TypeT, RowsT, ColsT> operator-(
+        Matrix<TypeT, RowsT, ColsT> lhs,
+        const Matrix<TypeT, RowsT, ColsT>& rhs)
+{
+    return lhs -= rhs;
+}
+
+template <typename TypeT, size_t RowsT, size_t ColsT, typename ScalarT,
+          typename = typename std::enable_if<
+                  IsVectorScalar<ScalarT>::value>::type>
+constexpr Matrix<TypeT, RowsT, ColsT> operator*(
+        Matrix<TypeT, RowsT, ColsT> lhs,
+        const ScalarT& rhs)
+{
+    return lhs *= rhs;
+}
+
+/*
+ *  \func operator*
+ *  \brief Multiplies two matrices. The result applies rhs first and then
+ *         lhs.
+ */
+template <typename TypeT, size_t RowsT, size_t InnerT, size_t ColsT>
+constexpr Matrix<TypeT, RowsT, ColsT> operator*(
+        const Matrix<TypeT, RowsT, InnerT>& lhs,
+        const Matrix<TypeT, InnerT, ColsT>& rhs)
+{
+    Matrix<TypeT, RowsT, ColsT> ret;
+    if constexpr (RowsT == InnerT && InnerT == ColsT)
+    {
+        MatrixKernels<TypeT, RowsT>::multiply(lhs.data(), rhs.data(),
+                                              ret.data());
+    }
+    else
+    {
+        for (size_t col = 0; col < ColsT; ++col)
+        {
+            for (size_t row = 0; row < RowsT; ++row)
+            {
+                TypeT sum = static_cast<TypeT>(0);
+                for (size_t ii = 0; ii < InnerT; ++ii)
+                {
+                    sum += lhs.data()[ii * RowsT + row] *
+                           rhs.data()[col * InnerT + ii];
+                }
+                ret.data()[col * RowsT + row] = sum;
+            }
+        }
+    }
+    return ret;
+}
+
+/*
+ *  \func operator*
+ *  \brief Transforms a column vector.
+ */
+template <typename TypeT, size_t RowsT, size_t ColsT>
+constexpr Vector<TypeT, RowsT> operator*(
+        const Matrix<TypeT, RowsT, ColsT>& lhs,
+        const Vector<TypeT, ColsT>& rhs)
+{
+    Vector<TypeT, RowsT> ret;
+    if constexpr (RowsT == ColsT)
+    {
+        MatrixKernels<TypeT, RowsT>::transform(lhs.data(), rhs.data(),
+                                               ret.data());
+    }
+    else
+    {
+        for (size_t col = 0; col < ColsT; ++col)
+        {
+            for (size_t row = 0; row < RowsT; ++row)
+            {
+                ret.data()[row] += lhs.data()[col * RowsT + row] *
+                                   rhs.data()[col];
+            }
+        }
+    }
+    return ret;
+}
+
+template <typename TypeT, size_t RowsT, size_t ColsT>
+constexpr Matrix<TypeT, ColsT, RowsT> transpose(
+        const Matrix<TypeT, RowsT, ColsT>& matrix)
+{
+    return matrix.transpose();
+}
+
+template <typename TypeT, size_t SizeT>
+constexpr Matrix<TypeT, SizeT, SizeT> inverse(
+        const Matrix<TypeT, SizeT, SizeT>& matrix)
+{
+    return matrix.inverse();
+}
+
+/*
+ *  \func transform
+ *  \brief Applies a square matrix to count contiguous vectors in one call.
+ *         in and out may be the same array.
+ *
+ *  \param matrix The transform to apply.
+ *  \param in The vectors to transform.
+ *  \param out [OUTPUT] The transformed vectors. This must hold count
+ *             vectors.
+ *  \param count The number of vectors.
+ *  \param pool Optional workers used to split large arrays.
+ */
+template <typename TypeT, size_t SizeT>
+void transform(const Matrix<TypeT, SizeT, SizeT>& matrix,
+               const Vector<TypeT, SizeT>* in,
+               Vector<TypeT, SizeT>* out,
+               size_t count,
+               ThreadPool* pool = nullptr)
+{
+    auto run = [&](size_t begin, size_t end)
+    {
+        MatrixKernels<TypeT, SizeT>::transformArray(
+                matrix.data(),
+                reinterpret_cast<const TypeT*>(in + begin),
+                reinterpret_cast<TypeT*>(out + begin),
+                end - begin);
+    };
+
+    if (pool)
+    {
+        pool->parallelFor(count, 65536, run);
+    }
+    else
+    {
+        run(0, count);
+    }
+}
+
+/*
+ *  \func transformPoints
+ *  \brief Applies an affine transform to count contiguous points in one
+ *         call, such as a Matrix4F to Vector3F points. Each point is
+ *         treated as having a final element of 1. in and out may be the
+ *         same array.
+ *
+ *  \param matrix The transform to apply. The last row is ignored.
+ *  \param in The points to transform.
+ *  \param out [OUTPUT] The transformed points. This must hold count
+ *             points.
+ *  \param count The number of points.
+ *  \param pool Optional workers used to split large arrays.
+ */
+template <typename TypeT, size_t SizeT>
+void transformPoints(const Matrix<TypeT, SizeT, SizeT>& matrix,
+                     const Vector<TypeT, SizeT - 1>* in,
+                     Vector<TypeT, SizeT - 1>* out,
+                     size_t count,
+                     ThreadPool* pool = nullptr)
+{
+    auto run = [&](size_t begin, size_t end)
+    {
+        MatrixKernels<TypeT, SizeT>::transformPoints(
+                matrix.data(),
+                reinterpret_cast<const TypeT*>(in + begin),
+                reinterpret_cast<TypeT*>(out + begin),
+                end - begin);
+    };
+
+    if (pool)
+    {
+        pool->parallelFor(count, 65536, run);
+    }
+    else
+    {
+        run(0, count);
+    }
+}
+
+template <typename TypeT, size_t RowsT, size_t ColsT>
+std::ostream& operator<<(std::ostream& os,
+                         const Matrix<TypeT, RowsT, ColsT>& matrix)
+{
+    for (size_t row = 0; row < RowsT; ++row)
+    {
+        os << (row ? "\n" : "") << matrix.getRow(row);
+    }
+    return os;
+}
+
+typedef Matrix<float, 2, 2> Matrix2F;
+typedef Matrix<float, 3, 3> Matrix3F;
+typedef Matrix<float, 4, 4> Matrix4F;
+typedef Matrix<double, 4, 4> Matrix4D;
+
+static_assert(sizeof(Matrix4F) == sizeof(float) * 16,
+              "Matrix4F must only contain its elements.");
+static_assert(std::is_trivially_copyable<Matrix4F>::value,
+              "Matrix must be trivially copyable.");
+}
+}
+
+#endif
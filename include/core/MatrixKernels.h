@@ -0,0 +1,815 @@
+/******************************************************************************
+ * The MIT License(MIT)
+ *
+ * Copyright(c) 2015 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+#ifndef __NYRA_CORE_MATRIX_KERNELS_H__
+#define __NYRA_CORE_MATRIX_KERNELS_H__
+
+#include <stddef.h>
+#include <core/VectorKernels.h>
+
+namespace nyra
+{
+namespace core
+{
+/*
+ *  \class MatrixLoops
+ *  \brief The operations used by square Matrix types written as plain
+ *         loops. Matrices are SizeT x SizeT elements stored column by
+ *         column, so element (row, col) is at col * SizeT + row. These can
+ *         be evaluated at compile time.
+ */
+template <typename TypeT, size_t SizeT>
+struct MatrixLoops
+{
+    /*
+     *  \func multiply
+     *  \brief Computes lhs * rhs. out must not overlap either input.
+     */
+    static constexpr void multiply(const TypeT* lhs,
+                                   const TypeT* rhs,
+                                   TypeT* out)
+    {
+        for (size_t col = 0; col < SizeT; ++col)
+        {
+            for (size_t row = 0; row < SizeT; ++row)
+            {
+                TypeT sum = static_cast<TypeT>(0);
+                for (size_t ii = 0; ii < SizeT; ++ii)
+                {
+                    sum += lhs[ii * SizeT + row] * rhs[col * SizeT + ii];
+                }
+                out[col * SizeT + row] = sum;
+            }
+        }
+    }
+
+    /*
+     *  \func transpose
+     *  \brief Swaps rows and columns. out must not overlap in.
+     */
+    static constexpr void transpose(const TypeT* in, TypeT* out)
+    {
+        for (size_t col = 0; col < SizeT; ++col)
+        {
+            for (size_t row = 0; row < SizeT; ++row)
+            {
+                out[row * SizeT + col] = in[col * SizeT + row];
+            }
+        }
+    }
+
+    /*
+     *  \func transform
+     *  \brief Computes matrix * in for a single vector of SizeT elements.
+     *         in and out may be the same vector.
+     */
+    static constexpr void transform(const TypeT* matrix,
+                                    const TypeT* in,
+                                    TypeT* out)
+    {
+        TypeT result[SizeT] = {};
+        for (size_t col = 0; col < SizeT; ++col)
+        {
+            for (size_t row = 0; row < SizeT; ++row)
+            {
+                result[row] += matrix[col * SizeT + row] * in[col];
+            }
+        }
+
+        for (size_t row = 0; row < SizeT; ++row)
+        {
+            out[row] = result[row];
+        }
+    }
+
+    /*
+     *  \func transformPoint
+     *  \brief Transforms a single point of SizeT - 1 elements as if it had
+     *         a final element of 1. The last row of the matrix is ignored,
+     *         so this is meant for affine transforms. in and out may be the
+     *         same point.
+     */
+    static constexpr void transformPoint(const TypeT* matrix,
+                                         const TypeT* in,
+                                         TypeT* out)
+    {
+        TypeT result[SizeT] = {};
+        for (size_t row = 0; row + 1 < SizeT; ++row)
+        {
+            result[row] = matrix[(SizeT - 1) * SizeT + row];
+        }
+
+        for (size_t col = 0; col + 1 < SizeT; ++col)
+        {
+            for (size_t row = 0; row + 1 < SizeT; ++row)
+            {
+                result[row] += matrix[col * SizeT + row] * in[col];
+            }
+        }
+
+        for (size_t row = 0; row + 1 < SizeT; ++row)
+        {
+            out[row] = result[row];
+        }
+    }
+
+    /*
+     *  \func transformArray
+     *  \brief Transforms count contiguous vectors of SizeT elements.
+     */
+    static void transformArray(const TypeT* matrix,
+                               const TypeT* in,
+                               TypeT* out,
+                               size_t count)
+    {
+        for (size_t ii = 0; ii < count; ++ii)
+        {
+            transform(matrix, in + ii * SizeT, out + ii * SizeT);
+        }
+    }
+
+    /*
+     *  \func transformPoints
+     *  \brief Transforms count contiguous points of SizeT - 1 elements.
+     */
+    static void transformPoints(const TypeT* matrix,
+                                const TypeT* in,
+                                TypeT* out,
+                                size_t count)
+    {
+        const size_t stride = SizeT - 1;
+        for (size_t ii = 0; ii < count; ++ii)
+        {
+            transformPoint(matrix, in + ii * stride, out + ii * stride);
+        }
+    }
+
+    /*
+     *  \func determinant
+     *  \brief Computes the determinant. Sizes 2 and 3 are expanded
+     *         directly, larger sizes use Gaussian elimination.
+     */
+    static constexpr TypeT determinant(const TypeT* in)
+    {
+        if constexpr (SizeT == 1)
+        {
+            return in[0];
+        }
+        else if constexpr (SizeT == 2)
+        {
+            return in[0] * in[3] - in[2] * in[1];
+        }
+        else if constexpr (SizeT == 3)
+        {
+            return in[0] * (in[4] * in[8] - in[7] * in[5]) -
+                   in[3] * (in[1] * in[8] - in[7] * in[2]) +
+                   in[6] * (in[1] * in[5] - in[4] * in[2]);
+        }
+        else
+        {
+            TypeT work[SizeT * SizeT] = {};
+            for (size_t ii = 0; ii < SizeT * SizeT; ++ii)
+            {
+                work[ii] = in[ii];
+            }
+
+            TypeT ret = static_cast<TypeT>(1);
+            for (size_t col = 0; col < SizeT; ++col)
+            {
+                const size_t pivot = findPivot(work, col);
+                if (work[col * SizeT + pivot] == static_cast<TypeT>(0))
+                {
+                    return static_cast<TypeT>(0);
+                }
+
+                if (pivot != col)
+                {
+                    swapRows(work, pivot, col);
+                    ret = -ret;
+                }
+
+                const TypeT diagonal = work[col * SizeT + col];
+                ret *= diagonal;
+                for (size_t row = col + 1; row < SizeT; ++row)
+                {
+                    const TypeT factor = work[col * SizeT + row] / diagonal;
+                    for (size_t ii = col; ii < SizeT; ++ii)
+                    {
+                        work[ii * SizeT + row] -=
+                                factor * work[ii * SizeT + col];
+                    }
+                }
+            }
+            return ret;
+        }
+    }
+
+    /*
+     *  \func inverse
+     *  \brief Computes the inverse. Sizes 2 and 3 use the adjugate, larger
+     *         sizes use Gauss-Jordan elimination with partial pivoting.
+     *         out must not overlap in.
+     *
+     *  \return false if the matrix is singular. out is unspecified then.
+     */
+    static constexpr bool inverse(const TypeT* in, TypeT* out)
+    {
+        if constexpr (SizeT <= 3)
+        {
+            const TypeT det = determinant(in);
+            if (det == static_cast<TypeT>(0))
+            {
+                return false;
+            }
+
+            const TypeT scale = static_cast<TypeT>(1) / det;
+            if constexpr (SizeT == 1)
+            {
+                out[0] = scale;
+            }
+            else if constexpr (SizeT == 2)
+            {
+                out[0] = in[3] * scale;
+                out[1] = -in[1] * scale;
+                out[2] = -in[2] * scale;
+                out[3] = in[0] * scale;
+            }
+            else
+            {
+                out[0] = (in[4] * in[8] - in[7] * in[5]) * scale;
+                out[1] = (in[7] * in[2] - in[1] * in[8]) * scale;
+                out[2] = (in[1] * in[5] - in[4] * in[2]) * scale;
+                out[3] = (in[6] * in[5] - in[3] * in[8]) * scale;
+                out[4] = (in[0] * in[8] - in[6] * in[2]) * scale;
+                out[5] = (in[3] * in[2] - in[0] * in[5]) * scale;
+                out[6] = (in[3] * in[7] - in[6] * in[4]) * scale;
+                out[7] = (in[6] * in[1] - in[0] * in[7]) * scale;
+                out[8] = (in[0] * in[4] - in[3] * in[1]) * scale;
+            }
+            return true;
+        }
+        else
+        {
+            TypeT work[SizeT * SizeT] = {};
+            for (size_t ii = 0; ii < SizeT * SizeT; ++ii)
+            {
+                work[ii] = in[ii];
+                out[ii] = static_cast<TypeT>(0);
+            }
+            for (size_t ii = 0; ii < SizeT; ++ii)
+            {
+                out[ii * SizeT + ii] = static_cast<TypeT>(1);
+            }
+
+            for (size_t col = 0; col < SizeT; ++col)
+            {
+                const size_t pivot = findPivot(work, col);
+                if (work[col * SizeT + pivot] == static_cast<TypeT>(0))
+                {
+                    return false;
+                }
+
+                swapRows(work, pivot, col);
+                swapRows(out, pivot, col);
+
+                const TypeT scale =
+                        static_cast<TypeT>(1) / work[col * SizeT + col];
+                for (size_t ii = 0; ii < SizeT; ++ii)
+                {
+                    work[ii * SizeT + col] *= scale;
+                    out[ii * SizeT + col] *= scale;
+                }
+
+                for (size_t row = 0; row < SizeT; ++row)
+                {
+                    const TypeT factor = work[col * SizeT + row];
+                    if (row == col || factor == static_cast<TypeT>(0))
+                    {
+                        continue;
+                    }
+
+                    for (size_t ii = 0; ii < SizeT; ++ii)
+                    {
+                        work[ii * SizeT + row] -=
+                                factor * work[ii * SizeT + col];
+                        out[ii * SizeT + row] -=
+                                factor * out[ii * SizeT + col];
+                    }
+                }
+            }
+            return true;
+        }
+    }
+
+private:
+    static constexpr TypeT absolute(TypeT value)
+    {
+        return value < static_cast<TypeT>(0) ? -value : value;
+    }
+
+    /*
+     *  Finds the row at or below col with the largest value in column col.
+     */
+    static constexpr size_t findPivot(const TypeT* values, size_t col)
+    {
+        size_t ret = col;
+        for (size_t row = col + 1; row < SizeT; ++row)
+        {
+            if (absolute(values[col * SizeT + row]) >
+                absolute(values[col * SizeT + ret]))
+            {
+                ret = row;
+            }
+        }
+        return ret;
+    }
+
+    static constexpr void swapRows(TypeT* values, size_t lhs, size_t rhs)
+    {
+        if (lhs == rhs)
+        {
+            return;
+        }
+
+        for (size_t col = 0; col < SizeT; ++col)
+        {
+            const TypeT temp = values[col * SizeT + lhs];
+            values[col * SizeT + lhs] = values[col * SizeT + rhs];
+            values[col * SizeT + rhs] = temp;
+        }
+    }
+};
+
+/*
+ *  \class MatrixSimd
+ *  \brief The runtime versions of the square Matrix operations. This uses
+ *         the loops by default and is specialized for float matrices that
+ *         map onto SSE registers.
+ */
+template <typename TypeT, size_t SizeT>
+struct MatrixSimd : public MatrixLoops<TypeT, SizeT>
+{
+};
+
+#ifdef NYRA_VECTOR_SSE2
+/*
+ *  A 2x2 matrix fits in one register as (m00, m10, m01, m11).
+ */
+template <>
+struct MatrixSimd<float, 2> : public MatrixLoops<float, 2>
+{
+    static void multiply(const float* lhs, const float* rhs, float* out)
+    {
+        const __m128 left = _mm_loadu_ps(lhs);
+        const __m128 right = _mm_loadu_ps(rhs);
+        const __m128 first = _mm_mul_ps(
+                _mm_movelh_ps(left, left),
+                _mm_shuffle_ps(right, right, _MM_SHUFFLE(2, 2, 0, 0)));
+        const __m128 second = _mm_mul_ps(
+                _mm_movehl_ps(left, left),
+                _mm_shuffle_ps(right, right, _MM_SHUFFLE(3, 3, 1, 1)));
+        _mm_storeu_ps(out, _mm_add_ps(first, second));
+    }
+
+    static void transpose(const float* in, float* out)
+    {
+        const __m128 values = _mm_loadu_ps(in);
+        _mm_storeu_ps(out, _mm_shuffle_ps(values, values,
+                                          _MM_SHUFFLE(3, 1, 2, 0)));
+    }
+
+    static bool inverse(const float* in, float* out)
+    {
+        const float det = determinant(in);
+        if (det == 0.0f)
+        {
+            return false;
+        }
+
+        const __m128 values = _mm_loadu_ps(in);
+        const __m128 scale = _mm_mul_ps(_mm_set1_ps(1.0f / det),
+                                        _mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f));
+        _mm_storeu_ps(out, _mm_mul_ps(_mm_shuffle_ps(
+                values, values, _MM_SHUFFLE(0, 2, 1, 3)), scale));
+        return true;
+    }
+};
+
+/*
+ *  3x3 matrices keep each column in the low three lanes of a register so
+ *  nothing past the end of the matrix or vector is touched.
+ */
+template <>
+struct MatrixSimd<float, 3> : public MatrixLoops<float, 3>
+{
+    static __m128 combine(const __m128* columns, const float* in)
+    {
+        __m128 ret = _mm_mul_ps(columns[0], _mm_set1_ps(in[0]));
+        ret = _mm_add_ps(ret, _mm_mul_ps(columns[1], _mm_set1_ps(in[1])));
+        return _mm_add_ps(ret, _mm_mul_ps(columns[2], _mm_set1_ps(in[2])));
+    }
+
+    static void loadColumns(const float* matrix, __m128* columns)
+    {
+        for (size_t ii = 0; ii < 3; ++ii)
+        {
+            columns[ii] = VectorSimd<float, 3>::load(matrix + ii * 3);
+        }
+    }
+
+    static void multiply(const float* lhs, const float* rhs, float* out)
+    {
+        __m128 columns[3];
+        loadColumns(lhs, columns);
+        for (size_t ii = 0; ii < 3; ++ii)
+        {
+            VectorSimd<float, 3>::store(out + ii * 3,
+                                        combine(columns, rhs + ii * 3));
+        }
+    }
+
+    static void transform(const float* matrix, const float* in, float* out)
+    {
+        __m128 columns[3];
+        loadColumns(matrix, columns);
+        VectorSimd<float, 3>::store(out, combine(columns, in));
+    }
+
+    static void transformArray(const float* matrix,
+                               const float* in,
+                               float* out,
+                               size_t count)
+    {
+        __m128 columns[3];
+        loadColumns(matrix, columns);
+        for (size_t ii = 0; ii < count; ++ii)
+        {
+            VectorSimd<float, 3>::store(out + ii * 3,
+                                        combine(columns, in + ii * 3));
+        }
+    }
+};
+
+/*
+ *  4x4 matrices keep one column per register. A vector is transformed by
+ *  broadcasting each of its elements and accumulating the columns.
+ */
+template <>
+struct MatrixSimd<float, 4> : public MatrixLoops<float, 4>
+{
+    static void loadColumns(const float* matrix, __m128* columns)
+    {
+        for (size_t ii = 0; ii < 4; ++ii)
+        {
+            columns[ii] = _mm_loadu_ps(matrix + ii * 4);
+        }
+    }
+
+    static __m128 combine(const __m128* columns, const float* in)
+    {
+        __m128 ret = _mm_mul_ps(columns[0], _mm_set1_ps(in[0]));
+        ret = _mm_add_ps(ret, _mm_mul_ps(columns[1], _mm_set1_ps(in[1])));
+        ret = _mm_add_ps(ret, _mm_mul_ps(columns[2], _mm_set1_ps(in[2])));
+        return _mm_add_ps(ret, _mm_mul_ps(columns[3], _mm_set1_ps(in[3])));
+    }
+
+    static __m128 combinePoint(const __m128* columns, const float* in)
+    {
+        __m128 ret = _mm_add_ps(columns[3],
+                                _mm_mul_ps(columns[0], _mm_set1_ps(in[0])));
+        ret = _mm_add_ps(ret, _mm_mul_ps(columns[1], _mm_set1_ps(in[1])));
+        return _mm_add_ps(ret, _mm_mul_ps(columns[2], _mm_set1_ps(in[2])));
+    }
+
+    static void multiply(const float* lhs, const float* rhs, float* out)
+    {
+        __m128 columns[4];
+        loadColumns(lhs, columns);
+        for (size_t ii = 0; ii < 4; ++ii)
+        {
+            _mm_storeu_ps(out + ii * 4, combine(columns, rhs + ii * 4));
+        }
+    }
+
+    static void transpose(const float* in, float* out)
+    {
+        __m128 columns[4];
+        loadColumns(in, columns);
+        _MM_TRANSPOSE4_PS(columns[0], columns[1], columns[2], columns[3]);
+        for (size_t ii = 0; ii < 4; ++ii)
+        {
+            _mm_storeu_ps(out + ii * 4, columns[ii]);
+        }
+    }
+
+    static void transform(const float* matrix, const float* in, float* out)
+    {
+        __m128 columns[4];
+        loadColumns(matrix, columns);
+        _mm_storeu_ps(out, combine(columns, in));
+    }
+
+    static void transformPoint(const float* matrix,
+                               const float* in,
+                               float* out)
+    {
+        __m128 columns[4];
+        loadColumns(matrix, columns);
+        VectorSimd<float, 3>::store(out, combinePoint(columns, in));
+    }
+
+    static void transformArray(const float* matrix,
+                               const float* in,
+                               float* out,
+                               size_t count)
+    {
+        __m128 columns[4];
+        loadColumns(matrix, columns);
+        for (size_t ii = 0; ii < count; ++ii)
+        {
+            _mm_storeu_ps(out + ii * 4, combine(columns, in + ii * 4));
+        }
+    }
+
+    static void transformPoints(const float* matrix,
+                                const float* in,
+                                float* out,
+                                size_t count)
+    {
+        __m128 columns[4];
+        loadColumns(matrix, columns);
+        for (size_t ii = 0; ii < count; ++ii)
+        {
+            VectorSimd<float, 3>::store(out + ii * 3,
+                                        combinePoint(columns, in + ii * 3));
+        }
+    }
+
+    /*
+     *  Inverts the matrix as four 2x2 blocks
+     *      | A C |
+     *      | B D |
+     *  using the adjugates (written A#) and determinants of the blocks.
+     *  Each block is held in one register as (b00, b10, b01, b11).
+     */
+    static bool inverse(const float* in, float* out)
+    {
+        __m128 columns[4];
+        loadColumns(in, columns);
+
+        const __m128 a = _mm_movelh_ps(columns[0], columns[1]);
+        const __m128 b = _mm_movehl_ps(columns[1], columns[0]);
+        const __m128 c = _mm_movelh_ps(columns[2], columns[3]);
+        const __m128 d = _mm_movehl_ps(columns[3], columns[2]);
+
+        // The determinants of the blocks as (|A|, |B|, |C|, |D|).
+        const __m128 dets = _mm_sub_ps(
+                _mm_mul_ps(_mm_shuffle_ps(columns[0], columns[2],
+                                          _MM_SHUFFLE(2, 0, 2, 0)),
+                           _mm_shuffle_ps(columns[1], columns[3],
+                                          _MM_SHUFFLE(3, 1, 3, 1))),
+                _mm_mul_ps(_mm_shuffle_ps(columns[0], columns[2],
+                                          _MM_SHUFFLE(3, 1, 3, 1)),
+                           _mm_shuffle_ps(columns[1], columns[3],
+                                          _MM_SHUFFLE(2, 0, 2, 0))));
+        const __m128 detA = broadcast<0>(dets);
+        const __m128 detB = broadcast<1>(dets);
+        const __m128 detC = broadcast<2>(dets);
+        const __m128 detD = broadcast<3>(dets);
+
+        const __m128 adjDC = adjugateMultiply(d, b);
+        const __m128 adjAC = adjugateMultiply(a, c);
+
+        // The adjugates of the blocks of the inverse, scaled by |M|.
+        __m128 topLeft = _mm_sub_ps(_mm_mul_ps(detD, a),
+                                    multiply2(c, adjDC));
+        __m128 bottomLeft = _mm_sub_ps(_mm_mul_ps(detB, c),
+                                       multiplyAdjugate(a, adjDC));
+        __m128 topRight = _mm_sub_ps(_mm_mul_ps(detC, b),
+                                     multiplyAdjugate(d, adjAC));
+        __m128 bottomRight = _mm_sub_ps(_mm_mul_ps(detA, d),
+                                        multiply2(b, adjAC));
+
+        // |M| = |A||D| + |B||C| - trace((A#C)(D#B))
+        const __m128 trace = _mm_mul_ps(
+                adjAC, _mm_shuffle_ps(adjDC, adjDC, _MM_SHUFFLE(3, 1, 2, 0)));
+        const float det = _mm_cvtss_f32(_mm_sub_ss(
+                _mm_add_ss(_mm_mul_ss(detA, detD), _mm_mul_ss(detB, detC)),
+                _mm_set_ss(horizontalSum(trace))));
+        if (det == 0.0f)
+        {
+            return false;
+        }
+
+        const __m128 scale = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f),
+                                        _mm_set1_ps(det));
+        topLeft = _mm_mul_ps(topLeft, scale);
+        bottomLeft = _mm_mul_ps(bottomLeft, scale);
+        topRight = _mm_mul_ps(topRight, scale);
+        bottomRight = _mm_mul_ps(bottomRight, scale);
+
+        // The rest of each adjugate is a swap of the diagonal, which is
+        // folded into the shuffles that put the blocks back into columns.
+        _mm_storeu_ps(out, _mm_shuffle_ps(topLeft, bottomLeft,
+                                          _MM_SHUFFLE(1, 3, 1, 3)));
+        _mm_storeu_ps(out + 4, _mm_shuffle_ps(topLeft, bottomLeft,
+                                              _MM_SHUFFLE(0, 2, 0, 2)));
+        _mm_storeu_ps(out + 8, _mm_shuffle_ps(topRight, bottomRight,
+                                              _MM_SHUFFLE(1, 3, 1, 3)));
+        _mm_storeu_ps(out + 12, _mm_shuffle_ps(topRight, bottomRight,
+                                               _MM_SHUFFLE(0, 2, 0, 2)));
+        return true;
+    }
+
+private:
+    template <int IndexT>
+    static __m128 broadcast(__m128 value)
+    {
+        return _mm_shuffle_ps(value, value,
+                              _MM_SHUFFLE(IndexT, IndexT, IndexT, IndexT));
+    }
+
+    /*
+     *  Computes lhs * rhs for 2x2 blocks.
+     */
+    static __m128 multiply2(__m128 lhs, __m128 rhs)
+    {
+        return _mm_add_ps(
+                _mm_mul_ps(_mm_movelh_ps(lhs, lhs),
+                           _mm_shuffle_ps(rhs, rhs, _MM_SHUFFLE(2, 2, 0, 0))),
+                _mm_mul_ps(_mm_movehl_ps(lhs, lhs),
+                           _mm_shuffle_ps(rhs, rhs, _MM_SHUFFLE(3, 3, 1, 1))));
+    }
+
+    /*
+     *  Computes lhs# * rhs for 2x2 blocks.
+     */
+    static __m128 adjugateMultiply(__m128 lhs, __m128 rhs)
+    {
+        return multiply2(_mm_mul_ps(
+                _mm_shuffle_ps(lhs, lhs, _MM_SHUFFLE(0, 2, 1, 3)),
+                _mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f)), rhs);
+    }
+
+    /*
+     *  Computes lhs * rhs# for 2x2 blocks.
+     */
+    static __m128 multiplyAdjugate(__m128 lhs, __m128 rhs)
+    {
+        return multiply2(lhs, _mm_mul_ps(
+                _mm_shuffle_ps(rhs, rhs, _MM_SHUFFLE(0, 2, 1, 3)),
+                _mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f)));
+    }
+};
+#endif
+
+#ifdef NYRA_HAS_CONSTANT_EVALUATED
+/*
+ *  \class MatrixKernels
+ *  \brief The operations used by square Matrix types. This uses the SIMD
+ *         versions at runtime and the plain loops at compile time. The
+ *         array versions only exist at runtime.
+ */
+template <typename TypeT, size_t SizeT>
+struct MatrixKernels
+{
+    static constexpr void multiply(const TypeT* lhs,
+                                   const TypeT* rhs,
+                                   TypeT* out)
+    {
+        if (isConstantEvaluated())
+        {
+            MatrixLoops<TypeT, SizeT>::multiply(lhs, rhs, out);
+        }
+        else
+        {
+            MatrixSimd<TypeT, SizeT>::multiply(lhs, rhs, out);
+        }
+    }
+
+    static constexpr void transpose(const TypeT* in, TypeT* out)
+    {
+        if (isConstantEvaluated())
+        {
+            MatrixLoops<TypeT, SizeT>::transpose(in, out);
+        }
+        else
+        {
+            MatrixSimd<TypeT, SizeT>::transpose(in, out);
+        }
+    }
+
+    static constexpr void transform(const TypeT* matrix,
+                                    const TypeT* in,
+                                    TypeT* out)
+    {
+        if (isConstantEvaluated())
+        {
+            MatrixLoops<TypeT, SizeT>::transform(matrix, in, out);
+        }
+        else
+        {
+            MatrixSimd<TypeT, SizeT>::transform(matrix, in, out);
+        }
+    }
+
+    static constexpr void transformPoint(const TypeT* matrix,
+                                         const TypeT* in,
+                                         TypeT* out)
+    {
+        if (isConstantEvaluated())
+        {
+            MatrixLoops<TypeT, SizeT>::transformPoint(matrix, in, out);
+        }
+        else
+        {
+            MatrixSimd<TypeT, SizeT>::transformPoint(matrix, in, out);
+        }
+    }
+
+    static constexpr TypeT determinant(const TypeT* in)
+    {
+        if (isConstantEvaluated())
+        {
+            return MatrixLoops<TypeT, SizeT>::determinant(in);
+        }
+        return MatrixSimd<TypeT, SizeT>::determinant(in);
+    }
+
+    static constexpr bool inverse(const TypeT* in, TypeT* out)
+    {
+        if (isConstantEvaluated())
+        {
+            return MatrixLoops<TypeT, SizeT>::inverse(in, out);
+        }
+        return MatrixSimd<TypeT, SizeT>::inverse(in, out);
+    }
+
+    static void transformArray(const TypeT* matrix,
+                               const TypeT* in,
+                               TypeT* out,
+                               size_t count)
+    {
+        MatrixSimd<TypeT, SizeT>::transformArray(matrix, in, out, count);
+    }
+
+    static void transformPoints(const TypeT* matrix,
+                                const TypeT* in,
+                                TypeT* out,
+                                size_t count)
+    {
+        MatrixSimd<TypeT, SizeT>::transformPoints(matrix, in, out, count);
+    }
+};
+#else
+/*
+ *  \class MatrixKernels
+ *  \brief The operations used by square Matrix types. The compiler cannot
+ *         tell compile time from runtime, so the constexpr operations use
+ *         the plain loops everywhere. The array versions only exist at
+ *         runtime and still use SIMD.
+ */
+template <typename TypeT, size_t SizeT>
+struct MatrixKernels : public MatrixLoops<TypeT, SizeT>
+{
+    static void transformArray(const TypeT* matrix,
+                               const TypeT* in,
+                               TypeT* out,
+                               size_t count)
+    {
+        MatrixSimd<TypeT, SizeT>::transformArray(matrix, in, out, count);
+    }
+
+    static void transformPoints(const TypeT* matrix,
+                                const TypeT* in,
+                                TypeT* out,
+                                size_t count)
+    {
+        MatrixSimd<TypeT, SizeT>::transformPoints(matrix, in, out, count);
+    }
+};
+#endif
+}
+}
+
+#endif
@@ -0,0 +1,359 @@
+/******************************************************************************
+ * The MIT License(MIT)
+ *
+ * Copyright(c) 2015 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+#ifndef __NYRA_CORE_QUATERNION_H__
+#define __NYRA_CORE_QUATERNION_H__
+
+#include <ostream>
+#include <cmath>
+#include <type_traits>
+#include <core/Vector.h>
+#include <core/Matrix.h>
+#include <core/Exception.h>
+
+namespace nyra
+{
+namespace core
+{
+/*
+ *  \class Quaternion
+ *  \brief A rotation stored as (x, y, z, w) where (x, y, z) is the vector
+ *         part and w is the scalar part. The elements are a Vector so they
+ *         use the same SIMD kernels. Rotations compose like matrices:
+ *         (lhs * rhs) applies rhs first.
+ */
+template <typename TypeT>
+struct Quaternion
+{
+    static_assert(std::is_floating_point<TypeT>::value,
+                  "Quaternions must use floating point elements.");
+
+    typedef TypeT Type;
+    typedef Vector<TypeT, 3> Vector3T;
+
+    /*
+     *  \func Constructor
+     *  \brief Creates the identity rotation.
+     */
+    constexpr Quaternion() :
+        mValues(0, 0, 0, 1)
+    {
+    }
+
+    constexpr Quaternion(const TypeT& x,
+                         const TypeT& y,
+                         const TypeT& z,
+                         const TypeT& w) :
+        mValues(x, y, z, w)
+    {
+    }
+
+    /*
+     *  \func fromAxisAngle
+     *  \brief Creates a rotation around an axis.
+     *
+     *  \param axis The axis to rotate around. This does not need to be
+     *              normalized.
+     *  \param radians The angle to rotate by, counter clockwise when
+     *                 looking down the axis.
+     *  \throw Exception if the axis has no length.
+     */
+    static Quaternion fromAxisAngle(const Vector3T& axis, TypeT radians)
+    {
+        const double length = axis.length();
+        if (length == 0.0)
+        {
+            throw core::Exception("Rotation axis has no length.");
+        }
+
+        const TypeT scale = static_cast<TypeT>(
+                std::sin(radians / 2) / length);
+        return Quaternion(axis.x() * scale,
+                          axis.y() * scale,
+                          axis.z() * scale,
+                          static_cast<TypeT>(std::cos(radians / 2)));
+    }
+
+    constexpr TypeT& x()
+    {
+        return mValues.x();
+    }
+
+    constexpr const TypeT& x() const
+    {
+        return mValues.x();
+    }
+
+    constexpr TypeT& y()
+    {
+        return mValues.y();
+    }
+
+    constexpr const TypeT& y() const
+    {
+        return mValues.y();
+    }
+
+    constexpr TypeT& z()
+    {
+        return mValues.z();
+    }
+
+    constexpr const TypeT& z() const
+    {
+        return mValues.z();
+    }
+
+    constexpr TypeT& w()
+    {
+        return mValues.w();
+    }
+
+    constexpr const TypeT& w() const
+    {
+        return mValues.w();
+    }
+
+    /*
+     *  \func getVector
+     *  \brief Gets the elements as (x, y, z, w).
+     */
+    constexpr const Vector<TypeT, 4>& getVector() const
+    {
+        return mValues;
+    }
+
+    constexpr bool operator==(const Quaternion& rhs) const
+    {
+        return mValues == rhs.mValues;
+    }
+
+    constexpr bool operator!=(const Quaternion& rhs) const
+    {
+        return mValues != rhs.mValues;
+    }
+
+    /*
+     *  \func operator*=
+     *  \brief Combines with another rotation that is applied first.
+     */
+    constexpr Quaternion& operator*=(const Quaternion& rhs)
+    {
+        const Vector<TypeT, 4>& a = mValues;
+        const Vector<TypeT, 4>& b = rhs.mValues;
+        *this = Quaternion(
+                a.w() * b.x() + a.x() * b.w() + a.y() * b.z() - a.z() * b.y(),
+                a.w() * b.y() - a.x() * b.z() + a.y() * b.w() + a.z() * b.x(),
+                a.w() * b.z() + a.x() * b.y() - a.y() * b.x() + a.z() * b.w(),
+                a.w() * b.w() - a.x() * b.x() - a.y() * b.y() - a.z() * b.z());
+        return *this;
+    }
+
+    constexpr TypeT dot(const Quaternion& rhs) const
+    {
+        return mValues.dot(rhs.mValues);
+    }
+
+    double length() const
+    {
+        return mValues.length();
+    }
+
+    constexpr double lengthSquared() const
+    {
+        return mValues.lengthSquared();
+    }
+
+    /*
+     *  \func normalize
+     *  \brief Scales to unit length. Rotations drift away from unit
+     *         length after many multiplies so this should be called
+     *         occasionally.
+     */
+    void normalize()
+    {
+        mValues.normalize();
+    }
+
+    /*
+     *  \func conjugate
+     *  \brief Gets the quaternion with the vector part negated. For a unit
+     *         quaternion this is the opposite rotation.
+     */
+    constexpr Quaternion conjugate() const
+    {
+        return Quaternion(-x(), -y(), -z(), w());
+    }
+
+    /*
+     *  \func inverse
+     *  \brief Gets the opposite rotation for a quaternion of any length.
+     *
+     *  \throw Exception if the quaternion has no length.
+     */
+    constexpr Quaternion inverse() const
+    {
+        const TypeT lengthSq = mValues.sumOfSquares();
+        if (lengthSq == static_cast<TypeT>(0))
+        {
+            throw core::Exception("Quaternion has no length.");
+        }
+
+        Quaternion ret = conjugate();
+        ret.mValues /= lengthSq;
+        return ret;
+    }
+
+    /*
+     *  \func rotate
+     *  \brief Rotates a vector. This assumes the quaternion is normalized.
+     *         To rotate many vectors convert to a matrix with toMatrix3 and
+     *         use transform.
+     */
+    constexpr Vector3T rotate(const Vector3T& vector) const
+    {
+        // v' = v + 2w(q x v) + 2q x (q x v)
+        const Vector3T axis(x(), y(), z());
+        const Vector3T twice = cross(axis, vector) * static_cast<TypeT>(2);
+        return vector + twice * w() + cross(axis, twice);
+    }
+
+    /*
+     *  \func toMatrix3
+     *  \brief Converts to a rotation matrix. This assumes the quaternion
+     *         is normalized.
+     */
+    constexpr Matrix<TypeT, 3, 3> toMatrix3() const
+    {
+        const TypeT one = static_cast<TypeT>(1);
+        const TypeT two = static_cast<TypeT>(2);
+        const TypeT xx = x() * x();
+        const TypeT yy = y() * y();
+        const TypeT zz = z() * z();
+        const TypeT xy = x() * y();
+        const TypeT xz = x() * z();
+        const TypeT yz = y() * z();
+        const TypeT wx = w() * x();
+        const TypeT wy = w() * y();
+        const TypeT wz = w() * z();
+
+        return Matrix<TypeT, 3, 3>(
+                one - two * (yy + zz), two * (xy - wz), two * (xz + wy),
+                two * (xy + wz), one - two * (xx + zz), two * (yz - wx),
+                two * (xz - wy), two * (yz + wx), one - two * (xx + yy));
+    }
+
+    /*
+     *  \func toMatrix4
+     *  \brief Converts to an affine rotation matrix. This assumes the
+     *         quaternion is normalized.
+     */
+    constexpr Matrix<TypeT, 4, 4> toMatrix4() const
+    {
+        const Matrix<TypeT, 3, 3> rotation = toMatrix3();
+        Matrix<TypeT, 4, 4> ret = Matrix<TypeT, 4, 4>::identity();
+        for (size_t col = 0; col < 3; ++col)
+        {
+            for (size_t row = 0; row < 3; ++row)
+            {
+                ret(row, col) = rotation(row, col);
+            }
+        }
+        return ret;
+    }
+
+private:
+    static constexpr Vector3T cross(const Vector3T& lhs, const Vector3T& rhs)
+    {
+        return Vector3T(lhs.y() * rhs.z() - lhs.z() * rhs.y(),
+                        lhs.z() * rhs.x() - lhs.x() * rhs.z(),
+                        lhs.x() * rhs.y() - lhs.y() * rhs.x());
+    }
+
+    Vector<TypeT, 4> mValues;
+};
+
+template <typename TypeT>
+constexpr Quaternion<TypeT> operator*(Quaternion<TypeT> lhs,
+                                      const Quaternion<TypeT>& rhs)
+{
+    return lhs *= rhs;
+}
+
+template <typename TypeT>
+inline Quaternion<TypeT> normalize(Quaternion<TypeT> quaternion)
+{
+    quaternion.normalize();
+    return quaternion;
+}
+
+/*
+ *  \func slerp
+ *  \brief Interpolates between two unit rotations at a constant angular
+ *         speed, taking the shorter path.
+ *
+ *  \param amount How far to go from lhs (0) to rhs (1).
+ */
+template <typename TypeT>
+Quaternion<TypeT> slerp(const Quaternion<TypeT>& lhs,
+                        Quaternion<TypeT> rhs,
+                        TypeT amount)
+{
+    TypeT cosine = lhs.dot(rhs);
+    if (cosine < 0)
+    {
+        rhs = Quaternion<TypeT>(-rhs.x(), -rhs.y(), -rhs.z(), -rhs.w());
+        cosine = -cosine;
+    }
+
+    TypeT lhsScale = 1 - amount;
+    TypeT rhsScale = amount;
+
+    // Nearly identical rotations fall back to a linear blend to avoid
+    // dividing by a tiny sine.
+    if (cosine < static_cast<TypeT>(0.9995))
+    {
+        const TypeT angle = std::acos(cosine);
+        const TypeT sine = std::sin(angle);
+        lhsScale = std::sin((1 - amount) * angle) / sine;
+        rhsScale = std::sin(amount * angle) / sine;
+    }
+
+    const Vector<TypeT, 4> values = lhs.getVector() * lhsScale +
+                                    rhs.getVector() * rhsScale;
+    return normalize(Quaternion<TypeT>(values.x(), values.y(),
+                                       values.z(), values.w()));
+}
+
+template <typename TypeT>
+std::ostream& operator<<(std::ostream& os, const Quaternion<TypeT>& quaternion)
+{
+    return os << quaternion.getVector();
+}
+
+typedef Quaternion<float> QuaternionF;
+typedef Quaternion<double> QuaternionD;
+}
+}
+
+#endif
@@ -0,0 +1,327 @@
+/******************************************************************************
+ * The MIT License(MIT)
+ *
+ * Copyright(c) 2015 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+#ifndef __NYRA_CORE_RING_BUFFER_H__
+#define __NYRA_CORE_RING_BUFFER_H__
+
+#include <stdint.h>
+#include <atomic>
+#include <vector>
+#include <algorithm>
+#include <core/Types.h>
+
+namespace nyra
+{
+namespace core
+{
+/*
+ *  \func - getRingCapacity
+ *  \brief - Rounds a requested capacity up to the power of two used by the
+ *           ring buffers so positions can be wrapped with a mask.
+ */
+inline size_t getRingCapacity(size_t capacity)
+{
+    size_t ret = 2;
+    while (ret < capacity)
+    {
+        ret <<= 1;
+    }
+    return ret;
+}
+
+/*
+ *  \class SpscRingBuffer
+ *  \brief A fixed size queue for exactly one producing thread and one
+ *         consuming thread. Neither side ever blocks or takes a lock.
+ *         Each side keeps a cached copy of the other side's position so
+ *         the shared positions are only read when the cached one says the
+ *         queue looks full or empty.
+ *
+ *  \tparam TypeT The stored type. It must be default constructible and
+ *          copyable.
+ */
+template <typename TypeT>
+class SpscRingBuffer
+{
+public:
+    /*
+     *  \func Constructor
+     *  \brief Allocates the queue.
+     *
+     *  \param capacity - The least number of items the queue can hold.
+     *         This is rounded up to a power of two.
+     */
+    explicit SpscRingBuffer(size_t capacity) :
+        mValues(getRingCapacity(capacity)),
+        mMask(mValues.size() - 1),
+        mHead(0),
+        mCachedTail(0),
+        mTail(0),
+        mCachedHead(0)
+    {
+    }
+
+    SpscRingBuffer(const SpscRingBuffer&) = delete;
+    SpscRingBuffer& operator=(const SpscRingBuffer&) = delete;
+
+    /*
+     *  \func - push
+     *  \brief - Adds items to the back of the queue. This may only be
+     *           called from the producing thread.
+     *
+     *  \param values - The items to add.
+     *  \param count - The number of items.
+     *  \return - The number of items added. This is less than count if
+     *            the queue filled up.
+     */
+    size_t push(const TypeT* values, size_t count)
+    {
+        const size_t tail = mTail.load(std::memory_order_relaxed);
+        if (mValues.size() - (tail - mCachedHead) < count)
+        {
+            mCachedHead = mHead.load(std::memory_order_acquire);
+        }
+
+        count = std::min(count, mValues.size() - (tail - mCachedHead));
+        for (size_t ii = 0; ii < count; ++ii)
+        {
+            mValues[(tail + ii) & mMask] = values[ii];
+        }
+        mTail.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+    bool push(const TypeT& value)
+    {
+        return push(&value, 1) == 1;
+    }
+
+    /*
+     *  \func - pop
+     *  \brief - Removes items from the front of the queue. This may only be
+     *           called from the consuming thread.
+     *
+     *  \param values - Where to copy the items.
+     *  \param count - The most items to remove.
+     *  \return - The number of items removed.
+     */
+    size_t pop(TypeT* values, size_t count)
+    {
+        const size_t head = mHead.load(std::memory_order_relaxed);
+        if (mCachedTail - head < count)
+        {
+            mCachedTail = mTail.load(std::memory_order_acquire);
+        }
+
+        count = std::min(count, mCachedTail - head);
+        for (size_t ii = 0; ii < count; ++ii)
+        {
+            values[ii] = mValues[(head + ii) & mMask];
+        }
+        mHead.store(head + count, std::memory_order_release);
+        return count;
+    }
+
+    bool pop(TypeT& value)
+    {
+        return pop(&value, 1) == 1;
+    }
+
+    /*
+     *  \func - size
+     *  \brief - Gets the number of queued items. This is only a snapshot
+     *           if the other thread is active.
+     */
+    size_t size() const
+    {
+        return mTail.load(std::memory_order_acquire) -
+               mHead.load(std::memory_order_acquire);
+    }
+
+    size_t capacity() const
+    {
+        return mValues.size();
+    }
+
+private:
+    std::vector<TypeT> mValues;
+    const size_t mMask;
+
+    // The consumer and producer positions live on separate cache lines so
+    // the two threads do not keep stealing the line from each other.
+    alignas(64) std::atomic<size_t> mHead;
+    size_t mCachedTail;
+    alignas(64) std::atomic<size_t> mTail;
+    size_t mCachedHead;
+};
+
+/*
+ *  \class MpscRingBuffer
+ *  \brief A fixed size queue that any number of threads can push to and a
+ *         single thread consumes. Producers claim a slot with a compare
+ *         and swap and mark it as filled with a per slot sequence number,
+ *         so a slow producer never stops the others and nothing blocks.
+ *
+ *  \tparam TypeT The stored type. It must be default constructible and
+ *          copyable.
+ */
+template <typename TypeT>
+class MpscRingBuffer
+{
+public:
+    /*
+     *  \func Constructor
+     *  \brief Allocates the queue.
+     *
+     *  \param capacity - The least number of items the queue can hold.
+     *         This is rounded up to a power of two.
+     */
+    explicit MpscRingBuffer(size_t capacity) :
+        mSlots(getRingCapacity(capacity)),
+        mMask(mSlots.size() - 1),
+        mHead(0),
+        mTail(0)
+    {
+        for (size_t ii = 0; ii < mSlots.size(); ++ii)
+        {
+            mSlots[ii].sequence.store(ii, std::memory_order_relaxed);
+        }
+    }
+
+    MpscRingBuffer(const MpscRingBuffer&) = delete;
+    MpscRingBuffer& operator=(const MpscRingBuffer&) = delete;
+
+    /*
+     *  \func - push
+     *  \brief - Adds an item to the back of the queue. This is safe to
+     *           call from any thread.
+     *
+     *  \param value - The item to add.
+     *  \return - False if the queue is full.
+     */
+    bool push(const TypeT& value)
+    {
+        size_t tail = mTail.load(std::memory_order_relaxed);
+        Slot* slot;
+        for (;;)
+        {
+            slot = &mSlots[tail & mMask];
+            const size_t sequence =
+                    slot->sequence.load(std::memory_order_acquire);
+            const ssize_t diff = static_cast<ssize_t>(sequence - tail);
+            if (diff == 0)
+            {
+                if (mTail.compare_exchange_weak(tail,
+                                                tail + 1,
+                                                std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                tail = mTail.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->value = value;
+        slot->sequence.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /*
+     *  \func - pop
+     *  \brief - Removes items from the front of the queue. This may only be
+     *           called from the consuming thread. It stops early at a slot
+     *           that has been claimed but not filled yet.
+     *
+     *  \param values - Where to copy the items.
+     *  \param count - The most items to remove.
+     *  \return - The number of items removed.
+     */
+    size_t pop(TypeT* values, size_t count)
+    {
+        size_t head = mHead.load(std::memory_order_relaxed);
+        size_t ii = 0;
+        for (; ii < count; ++ii, ++head)
+        {
+            Slot& slot = mSlots[head & mMask];
+            if (slot.sequence.load(std::memory_order_acquire) != head + 1)
+            {
+                break;
+            }
+
+            values[ii] = slot.value;
+            slot.sequence.store(head + mSlots.size(),
+                                std::memory_order_release);
+        }
+        mHead.store(head, std::memory_order_relaxed);
+        return ii;
+    }
+
+    bool pop(TypeT& value)
+    {
+        return pop(&value, 1) == 1;
+    }
+
+    /*
+     *  \func - size
+     *  \brief - Gets the number of claimed slots. This is only a snapshot
+     *           while other threads are active.
+     */
+    size_t size() const
+    {
+        return mTail.load(std::memory_order_relaxed) -
+               mHead.load(std::memory_order_relaxed);
+    }
+
+    size_t capacity() const
+    {
+        return mSlots.size();
+    }
+
+private:
+    struct Slot
+    {
+        Slot() :
+            sequence(0)
+        {
+        }
+
+        std::atomic<size_t> sequence;
+        TypeT value;
+    };
+
+    std::vector<Slot> mSlots;
+    const size_t mMask;
+    alignas(64) std::atomic<size_t> mHead;
+    alignas(64) std::atomic<size_t> mTail;
+};
+}
+}
+
+#endif
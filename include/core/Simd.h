@@ -0,0 +1,93 @@
+/******************************************************************************
+ * The MIT License(MIT)
+ *
+ * Copyright(c) 2015 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+#ifndef __NYRA_CORE_SIMD_H__
+#define __NYRA_CORE_SIMD_H__
+
+#include <stdint.h>
+
+#if defined(_M_X64) || defined(_M_IX86) || \
+    defined(__x86_64__) || defined(__i386__)
+#define NYRA_X86 1
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+/*
+ *  \def NYRA_TARGET
+ *  \brief Allows a single function to be compiled for an instruction set
+ *         that the rest of the build does not assume. MSVC allows any
+ *         intrinsic to be used so this is empty there. Functions marked
+ *         with this must only be called after checking the matching
+ *         has* function.
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#define NYRA_TARGET(isa) __attribute__((target(isa)))
+#else
+#define NYRA_TARGET(isa)
+#endif
+
+namespace nyra
+{
+namespace core
+{
+/*
+ *  \func - hasSSE2
+ *  \brief - Checks if the CPU running the program supports SSE2.
+ */
+bool hasSSE2();
+
+/*
+ *  \func - hasSSSE3
+ *  \brief - Checks if the CPU running the program supports SSSE3.
+ */
+bool hasSSSE3();
+
+/*
+ *  \func - hasAVX2
+ *  \brief - Checks if the CPU and operating system support AVX2.
+ */
+bool hasAVX2();
+
+/*
+ *  \func - countTrailingZeros
+ *  \brief - Gets the index of the lowest set bit.
+ *
+ *  \param value - The value to check. This must not be 0.
+ */
+inline uint32_t countTrailingZeros(uint32_t value)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, value);
+    return static_cast<uint32_t>(index);
+#else
+    return static_cast<uint32_t>(__builtin_ctz(value));
+#endif
+}
+}
+}
+
+#endif
@@ -0,0 +1,286 @@
+/******************************************************************************
+ * The MIT License(MIT)
+ *
+ * Copyright(c) 2015 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+#ifndef __NYRA_CORE_SPATIAL_GRID_H__
+#define __NYRA_CORE_SPATIAL_GRID_H__
+
+#include <stdint.h>
+#include <vector>
+#include <unordered_map>
+#include <core/Vector.h>
+#include <core/Bounds.h>
+#include <core/ThreadPool.h>
+
+namespace nyra
+{
+namespace core
+{
+/*
+ *  \class SpatialGrid
+ *  \brief A uniform grid over 2D points for proximity queries on data that
+ *         moves every frame. Only occupied cells are stored, in a hash map,
+ *         so the world does not need fixed limits. Moving a point only
+ *         touches the grid when it crosses into another cell. Each point is
+ *         identified by a caller chosen id, such as an entity index. Ids
+ *         should be small and dense because lookups index an array by id.
+ *
+ *         The cell size should be about the radius of a typical query.
+ */
+class SpatialGrid
+{
+public:
+    typedef uint32_t Id;
+
+    /*
+     *  \func Constructor
+     *  \brief Creates an empty grid.
+     *
+     *  \param cellSize The width and height of each cell.
+     *  \throw Exception if cellSize is not positive.
+     */
+    explicit SpatialGrid(float cellSize);
+
+    /*
+     *  \func build
+     *  \brief Replaces the contents of the grid with an array of points.
+     *         The id of each point is its index. This is much faster than
+     *         inserting points one at a time.
+     *
+     *  \param positions The points to add.
+     *  \param count The number of points.
+     *  \param pool Optional workers used to split the work.
+     */
+    void build(const Vector2F* positions,
+               size_t count,
+               ThreadPool* pool = nullptr);
+
+    void build(const std::vector<Vector2F>& positions,
+               ThreadPool* pool = nullptr)
+    {
+        build(positions.data(), positions.size(), pool);
+    }
+
+    /*
+     *  \func insert
+     *  \brief Adds a point.
+     *
+     *  \throw Exception if the id is already in the grid.
+     */
+    void insert(Id id, const Vector2F& position);
+
+    /*
+     *  \func update
+     *  \brief Moves a point.
+     *
+     *  \throw Exception if the id is not in the grid.
+     */
+    void update(Id id, const Vector2F& position);
+
+    /*
+     *  \func remove
+     *  \brief Removes a point.
+     *
+     *  \throw Exception if the id is not in the grid.
+     */
+    void remove(Id id);
+
+    /*
+     *  \func clear
+     *  \brief Removes every point.
+     */
+    void clear();
+
+    bool contains(Id id) const
+    {
+        return id < mEntries.size() && mEntries[id].active;
+    }
+
+    /*
+     *  \func getPosition
+     *  \brief Gets the position of a point.
+     *
+     *  \throw Exception if the id is not in the grid.
+     */
+    const Vector2F& getPosition(Id id) const;
+
+    size_t size() const
+    {
+        return mSize;
+    }
+
+    bool empty() const
+    {
+        return mSize == 0;
+    }
+
+    float getCellSize() const
+    {
+        return mCellSize;
+    }
+
+    /*
+     *  \func queryRadius
+     *  \brief Finds every point within a distance of center, including
+     *         points exactly radius away. Results are in no particular
+     *         order.
+     *
+     *  \param out [OUTPUT] The ids of the points. Ids are appended, out is
+     *             not cleared.
+     */
+    void queryRadius(const Vector2F& center,
+                     float radius,
+                     std::vector<Id>& out) const;
+
+    /*
+     *  \func queryBounds
+     *  \brief Finds every point inside a box, including its edges. Results
+     *         are in no particular order.
+     *
+     *  \param out [OUTPUT] The ids of the points. Ids are appended, out is
+     *             not cleared.
+     */
+    void queryBounds(const Bounds2F& bounds, std::vector<Id>& out) const;
+
+    /*
+     *  \func queryNearest
+     *  \brief Finds the points closest to center.
+     *
+     *  \param count The number of points to find. Fewer are returned if
+     *               the grid holds fewer points.
+     *  \param out [OUTPUT] The ids of the points, nearest first. Ids are
+     *             appended, out is not cleared.
+     */
+    void queryNearest(const Vector2F& center,
+                      size_t count,
+                      std::vector<Id>& out) const;
+
+private:
+    /*
+     *  A point as stored in a cell. The position is kept next to the id so
+     *  queries read each cell contiguously.
+     */
+    struct Item
+    {
+        Vector2F position;
+        Id id;
+    };
+
+    struct Entry
+    {
+        uint64_t cell;
+        uint32_t slot;
+        bool active;
+    };
+
+    typedef std::vector<Item> Cell;
+    typedef std::vector<std::pair<float, Id> > NearestHeap;
+
+    int32_t getCoordinate(float value) const;
+
+    uint64_t getCell(const Vector2F& position) const
+    {
+        return makeCell(getCoordinate(position.x()),
+                        getCoordinate(position.y()));
+    }
+
+    static uint64_t makeCell(int32_t x, int32_t y)
+    {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) |
+               static_cast<uint32_t>(y);
+    }
+
+    static int32_t getCellX(uint64_t cell)
+    {
+        return static_cast<int32_t>(static_cast<uint32_t>(cell >> 32));
+    }
+
+    static int32_t getCellY(uint64_t cell)
+    {
+        return static_cast<int32_t>(static_cast<uint32_t>(cell));
+    }
+
+    void addToCell(Id id, const Vector2F& position, uint64_t cell);
+
+    void removeFromCell(Id id);
+
+    const Entry& getEntry(Id id) const;
+
+    /*
+     *  Calls func for every occupied cell between two corners. If the
+     *  range holds more cells than are occupied the occupied cells are
+     *  scanned instead.
+     */
+    template <typename FuncT>
+    void forEachCell(int32_t minX,
+                     int32_t minY,
+                     int32_t maxX,
+                     int32_t maxY,
+                     FuncT func) const
+    {
+        const uint64_t width = static_cast<uint64_t>(
+                static_cast<int64_t>(maxX) - minX + 1);
+        const uint64_t height = static_cast<uint64_t>(
+                static_cast<int64_t>(maxY) - minY + 1);
+        if (width * height > mCells.size())
+        {
+            for (auto it = mCells.begin(); it != mCells.end(); ++it)
+            {
+                const int32_t x = getCellX(it->first);
+                const int32_t y = getCellY(it->first);
+                if (x >= minX && x <= maxX && y >= minY && y <= maxY)
+                {
+                    func(it->second);
+                }
+            }
+            return;
+        }
+
+        for (int64_t x = minX; x <= maxX; ++x)
+        {
+            for (int64_t y = minY; y <= maxY; ++y)
+            {
+                auto it = mCells.find(makeCell(static_cast<int32_t>(x),
+                                               static_cast<int32_t>(y)));
+                if (it != mCells.end())
+                {
+                    func(it->second);
+                }
+            }
+        }
+    }
+
+    void addNearest(const Cell& cell,
+                    const Vector2F& center,
+                    size_t count,
+                    NearestHeap& heap) const;
+
+    float mCellSize;
+    float mInverseCellSize;
+    size_t mSize;
+    std::unordered_map<uint64_t, Cell> mCells;
+    std::vector<Entry> mEntries;
+};
+}
+}
+
+#endif
@@ -25,9 +25,15 @@
 #define __NYRA_CORE_STRING_CONVERT_H__
 
 #include <stdint.h>
+#include <cctype>
+#include <charconv>
 #include <string>
+#include <string_view>
+#include <vector>
 #include <sstream>
 #include <limits>
+#include <algorithm>
+#include <type_traits>
 #include <core/Exception.h>
 #include <core/StringUtils.h>
 
@@ -47,20 +53,104 @@ template<typename T> size_t getPrecision(const T&)
     return 0;
 }
 
+/*
+ *  \class IsCharsConvertible
+ *  \brief Checks if a type is converted with std::from_chars and
+ *         std::to_chars. This is true for integer and floating point types
+ *         other than bool and the character types, which keep their stream
+ *         behavior of reading and writing a single character.
+ */
+template <typename T>
+struct IsCharsConvertible : std::integral_constant<bool,
+        std::is_arithmetic<T>::value &&
+        !std::is_same<T, bool>::value &&
+        !std::is_same<T, char>::value &&
+        !std::is_same<T, signed char>::value &&
+        !std::is_same<T, unsigned char>::value &&
+        !std::is_same<T, wchar_t>::value &&
+        !std::is_same<T, char16_t>::value &&
+        !std::is_same<T, char32_t>::value>
+{
+};
+
+/*
+ *  \func - hexEncode
+ *  \brief - Writes a buffer as uppercase hexadecimal. Each byte becomes
+ *           two characters in the order they appear in memory. Large
+ *           buffers are encoded with SIMD when the CPU supports it.
+ *
+ *  \param data - The bytes to encode.
+ *  \param size - The number of bytes to encode.
+ *  \param out [OUTPUT] - The buffer to write. This must hold size * 2
+ *         characters. The result is not null terminated.
+ */
+void hexEncode(const void* data, size_t size, char* out);
+
+/*
+ *  \func - toHexString
+ *  \brief - Converts a buffer to a hexadecimal based string. This is useful
+ *           to dump the result of readBinary.
+ *
+ *  \param data - The bytes to convert.
+ *  \return - A string with two characters for every byte.
+ */
+std::string toHexString(const std::vector<uint8_t>& data);
+
+/*
+ *  \func - toHexChars
+ *  \brief - Writes a value as hexadecimal into a buffer. This will 0 pad
+ *           numbers on the left to fill the number of bytes in the
+ *           datatype. The result is not null terminated.
+ *
+ *  \param T - The datatype of the value. This must be an integer or enum.
+ *  \param value - The value to convert.
+ *  \param buffer [OUTPUT] - The buffer to write into.
+ *  \param size - The size of the buffer in bytes.
+ *  \return - The number of characters written. This is always
+ *            sizeof(T) * 2.
+ *  \throw - If the buffer is too small.
+ */
+template<typename T> size_t toHexChars(const T& value, char* buffer, size_t size)
+{
+    typedef typename std::conditional<std::is_enum<T>::value,
+                                      std::underlying_type<T>,
+                                      std::common_type<T> >::type::type
+            IntegerT;
+    typedef typename std::conditional<std::is_same<IntegerT, bool>::value,
+                                      std::common_type<uint8_t>,
+                                      std::make_unsigned<IntegerT> >::type::type
+            UnsignedT;
+    static const char digits[] = "0123456789ABCDEF";
+
+    const size_t length = sizeof(T) * 2;
+    if (size < length)
+    {
+        throw Exception("Buffer is too small to convert value.");
+    }
+
+    // Fill from the least significant digit backwards.
+    UnsignedT bits = static_cast<UnsignedT>(value);
+    for (size_t ii = length; ii > 0; --ii)
+    {
+        buffer[ii - 1] = digits[bits & 0xF];
+        bits = static_cast<UnsignedT>(bits >> 4);
+    }
+    return length;
+}
+
 /*
  *  \func - toHexString
  *  \brief - Converts a value to a hexadecimal based string. This will 0 pad
  *           numbers on the left to fill the number of bytes in the datatype.
  *
- *  \param T - The datatype of the value.
+ *  \param T - The datatype of the value. This must be an integer or enum.
  *  \param value - The value to convert.
  *  \return - The 0 padded formatted string.
  */
 template<typename T> std::string toHexString(const T& value)
 {
-    std::ostringstream buffer;
-    buffer << std::hex << static_cast<size_t>(value);
-    return pad(toUpper(buffer.str()), '0', sizeof(T) * 2);
+    char buffer[sizeof(T) * 2];
+    return std::string(buffer, toHexChars(value, buffer, sizeof(buffer)));
 }
 
 /*
@@ -76,6 +166,26 @@ template<typename T> std::string toHexString(const T& value)
 template<typename T> std::string toString(const T& value,
                                           size_t precision)
 {
+    if constexpr (std::is_floating_point<T>::value)
+    {
+        // Matches the stream's default (general) formatting.
+        char buffer[128];
+        const std::to_chars_result result = std::to_chars(
+                buffer, buffer + sizeof(buffer), value,
+                std::chars_format::general, static_cast<int>(precision));
+        if (result.ec == std::errc())
+        {
+            return std::string(buffer, result.ptr);
+        }
+    }
+    else if constexpr (IsCharsConvertible<T>::value)
+    {
+        char buffer[32];
+        const std::to_chars_result result = std::to_chars(
+                buffer, buffer + sizeof(buffer), value);
+        return std::string(buffer, result.ptr);
+    }
+
     std::ostringstream buffer;
     buffer.precision(precision);
     buffer << std::boolalpha << value;
@@ -84,18 +194,173 @@ template<typename T> std::string toString(const T& value,
 
 /*
  *  \func toString
- *  \brief Converts a value to a string.
+ *  \brief Converts a value to a string. Integer and floating point values
+ *         are written with std::to_chars. Floating point values use the
+ *         shortest representation that reads back as exactly the same
+ *         value.
  *
  *  \param value The value to turn into a string.
  *  \return The string of the value.
  */
 template<typename T> std::string toString(const T& value)
 {
+    if constexpr (IsCharsConvertible<T>::value)
+    {
+        char buffer[64];
+        const std::to_chars_result result = std::to_chars(
+                buffer, buffer + sizeof(buffer), value);
+        if (result.ec == std::errc())
+        {
+            return std::string(buffer, result.ptr);
+        }
+    }
+    else if constexpr (std::is_same<T, bool>::value)
+    {
+        return value ? "true" : "false";
+    }
+
     return toString<T>(
             value,
             getPrecision<T>(value));
 }
 
+/*
+ *  \func toChars
+ *  \brief Writes a value into a character buffer. This produces the same
+ *         text as toString but never allocates for integer, floating point
+ *         or bool values. The result is not null terminated.
+ *
+ *  \param value The value to turn into a string.
+ *  \param buffer [OUTPUT] The buffer to write into.
+ *  \param size The size of the buffer in bytes.
+ *  \return The number of characters written.
+ *  \throw Exception if the buffer is too small.
+ */
+template<typename T> size_t toChars(const T& value, char* buffer, size_t size)
+{
+    if constexpr (IsCharsConvertible<T>::value)
+    {
+        const std::to_chars_result result = std::to_chars(
+                buffer, buffer + size, value);
+        if (result.ec != std::errc())
+        {
+            throw Exception("Buffer is too small to convert value.");
+        }
+        return static_cast<size_t>(result.ptr - buffer);
+    }
+    else if constexpr (std::is_same<T, bool>::value)
+    {
+        const std::string_view text(value ? "true" : "false");
+        if (text.size() > size)
+        {
+            throw Exception("Buffer is too small to convert value.");
+        }
+        std::copy(text.begin(), text.end(), buffer);
+        return text.size();
+    }
+    else
+    {
+        const std::string text = toString(value);
+        if (text.size() > size)
+        {
+            throw Exception("Buffer is too small to convert value.");
+        }
+        std::copy(text.begin(), text.end(), buffer);
+        return text.size();
+    }
+}
+
+/*
+ *  \func appendString
+ *  \brief Converts a value to a string and appends it to an existing
+ *         string. Once out has enough capacity this does not allocate for
+ *         integer, floating point or bool values, so the same string can
+ *         be reused to serialize many values.
+ *
+ *  \param value The value to turn into a string.
+ *  \param out [OUTPUT] The string to append to.
+ */
+template<typename T> void appendString(const T& value, std::string& out)
+{
+    if constexpr (IsCharsConvertible<T>::value ||
+                  std::is_same<T, bool>::value)
+    {
+        char buffer[64];
+        out.append(buffer, toChars(value, buffer, sizeof(buffer)));
+    }
+    else
+    {
+        out += toString(value);
+    }
+}
+
+/*
+ *  \func tryToType
+ *  \brief Converts a string to a value without throwing. Numeric types are
+ *         parsed with std::from_chars which does not allocate or depend on
+ *         the locale. Leading and trailing whitespace and a leading + are
+ *         allowed, anything else after the number is an error.
+ *
+ *  \param s The string you want to convert.
+ *  \param value [OUTPUT] The value the string contained. This is only
+ *               modified if the conversion succeeds.
+ *  \return False if the string is empty or cannot be converted.
+ */
+template<typename T> bool tryToType(std::string_view s, T& value)
+{
+    if constexpr (IsCharsConvertible<T>::value)
+    {
+        const char* begin = s.data();
+        const char* end = begin + s.size();
+        while (begin != end && std::isspace(static_cast<unsigned char>(*begin)))
+        {
+            ++begin;
+        }
+        while (begin != end && std::isspace(static_cast<unsigned char>(end[-1])))
+        {
+            --end;
+        }
+        if (end - begin > 1 && *begin == '+' && begin[1] != '-')
+        {
+            ++begin;
+        }
+        if (begin == end)
+        {
+            return false;
+        }
+
+        T result;
+        const std::from_chars_result parsed = std::from_chars(begin, end, result);
+        if (parsed.ec != std::errc() || parsed.ptr != end)
+        {
+            return false;
+        }
+
+        value = result;
+        return true;
+    }
+    else
+    {
+        if (s.empty())
+        {
+            return false;
+        }
+
+        T result;
+        std::stringstream buffer{std::string(s)};
+        buffer.precision(getPrecision<T>(result));
+        buffer >> result;
+
+        if (buffer.fail())
+        {
+            return false;
+        }
+
+        value = result;
+        return true;
+    }
+}
+
 /*
  *  \func toType
  *  \brief Converts a string to a value.
@@ -111,16 +376,19 @@ template<typename T> T toType(const std::string& s)
         throw Exception("Trying to covert an empty string.");
 
     T value;
-
-    std::stringstream buffer(s);
-    buffer.precision(getPrecision<T>(value));
-    buffer >> value;
-
-    if (buffer.fail())
+    if (!tryToType(s, value))
         throw Exception("Failed to convert: " + s);
 
     return value;
 }
+
+template<> bool tryToType<bool>(std::string_view s, bool& value);
+
+template<> bool tryToType<std::string>(std::string_view s, std::string& value);
+
+template<> bool toType<bool>(const std::string& s);
+
+template<> std::string toType<std::string>(const std::string& s);
 }
 }
 
@@ -25,7 +25,9 @@
 #define __NYRA_CORE_STRING_UTILS_H__
 
 #include <string>
+#include <string_view>
 #include <vector>
+#include <iterator>
 #include <algorithm>
 #include <sstream>
 #include <iomanip>
@@ -35,6 +37,175 @@ namespace nyra
 {
 namespace core
 {
+/*
+ *  \class Tokenizer
+ *  \brief Lazily splits a string by a deliminator. Tokens are views into
+ *         the original string so nothing is copied or allocated. The
+ *         string must outlive the tokenizer and its iterators. The tokens
+ *         are the same as the ones produced by split.
+ *
+ *         for (std::string_view token : Tokenizer(line, ","))
+ */
+class Tokenizer
+{
+public:
+    /*
+     *  \class Iterator
+     *  \brief Forward iterator over the tokens.
+     */
+    class Iterator
+    {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef std::string_view value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const std::string_view* pointer;
+        typedef const std::string_view& reference;
+
+        /*
+         *  \func Constructor
+         *  \brief Creates an end iterator.
+         */
+        Iterator() :
+            mPosition(std::string_view::npos),
+            mNext(std::string_view::npos)
+        {
+        }
+
+        /*
+         *  \func Constructor
+         *  \brief Creates an iterator pointing at the first token.
+         */
+        Iterator(std::string_view input, std::string_view delim) :
+            mInput(input),
+            mDelim(delim),
+            mPosition(0),
+            mNext(0)
+        {
+            findToken();
+        }
+
+        reference operator*() const
+        {
+            return mToken;
+        }
+
+        pointer operator->() const
+        {
+            return &mToken;
+        }
+
+        Iterator& operator++()
+        {
+            mPosition = mNext;
+            if (mPosition != std::string_view::npos)
+            {
+                findToken();
+            }
+            return *this;
+        }
+
+        Iterator operator++(int)
+        {
+            Iterator ret(*this);
+            ++(*this);
+            return ret;
+        }
+
+        bool operator==(const Iterator& rhs) const
+        {
+            return mPosition == rhs.mPosition;
+        }
+
+        bool operator!=(const Iterator& rhs) const
+        {
+            return mPosition != rhs.mPosition;
+        }
+
+    private:
+        void findToken()
+        {
+            const size_t end = mDelim.empty() ?
+                    std::string_view::npos :
+                    mInput.find(mDelim, mPosition);
+            if (end == std::string_view::npos)
+            {
+                // This is the last token.
+                mToken = mInput.substr(mPosition);
+                mNext = std::string_view::npos;
+            }
+            else
+            {
+                mToken = mInput.substr(mPosition, end - mPosition);
+                mNext = end + mDelim.size();
+            }
+        }
+
+        std::string_view mInput;
+        std::string_view mDelim;
+        std::string_view mToken;
+        size_t mPosition;
+        size_t mNext;
+    };
+
+    /*
+     *  \func Constructor
+     *  \brief Sets up the tokenizer. No work is done until it is iterated.
+     *
+     *  \param input - The string to split.
+     *  \param delim - The string to split at. An empty deliminator
+     *         produces the whole input as a single token.
+     */
+    Tokenizer(std::string_view input, std::string_view delim) :
+        mInput(input),
+        mDelim(delim)
+    {
+    }
+
+    Iterator begin() const
+    {
+        return Iterator(mInput, mDelim);
+    }
+
+    Iterator end() const
+    {
+        return Iterator();
+    }
+
+private:
+    std::string_view mInput;
+    std::string_view mDelim;
+};
+
+/*
+ *  \func - findAll
+ *  \brief - Finds every non-overlapping occurrence of a deliminator. The
+ *           input is scanned with SIMD when the CPU supports it.
+ *           Offsets are appended to ret, it is not cleared.
+ *
+ *  \param s - The string to search.
+ *  \param delim - The string to search for. Nothing is found if this is
+ *         empty.
+ *  \param ret [OUTPUT] - The byte offset of each occurrence.
+ */
+void findAll(std::string_view s,
+             std::string_view delim,
+             std::vector<size_t>& ret);
+
+/*
+ *  \func - split
+ *  \brief - Splits a string be a deliminator. The tokens are views into
+ *           the original string so once ret has enough capacity this does
+ *           not allocate. Tokens are appended to ret, it is not cleared.
+ *
+ *  \param s - The string to split. This must outlive the tokens.
+ *  \param delim - The string to split at.
+ *  \param ret [OUTPUT] - The output vector.
+ */
+void split(std::string_view s,
+           std::string_view delim,
+           std::vector<std::string_view>& ret);
+
 /*
  *  \func - split
  *  \brief - Splits a string be a deliminator.
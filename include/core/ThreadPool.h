@@ -0,0 +1,192 @@
+/******************************************************************************
+ * The MIT License(MIT)
+ *
+ * Copyright(c) 2015 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+#ifndef __NYRA_CORE_THREAD_POOL_H__
+#define __NYRA_CORE_THREAD_POOL_H__
+
+#include <vector>
+#include <algorithm>
+#include <exception>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <utility>
+
+namespace nyra
+{
+namespace core
+{
+/*
+ *  \class ThreadPool
+ *  \brief A fixed set of worker threads that run queued tasks in the order
+ *         they were submitted. The destructor finishes every queued task
+ *         before joining the workers.
+ */
+class ThreadPool
+{
+public:
+    /*
+     *  \func Constructor
+     *  \brief Starts the worker threads.
+     *
+     *  \param numThreads - The number of workers. Passing 0 uses the
+     *         number of hardware threads.
+     */
+    explicit ThreadPool(size_t numThreads = 0);
+
+    /*
+     *  \func Destructor
+     *  \brief Waits for all queued tasks and stops the workers.
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /*
+     *  \func - submit
+     *  \brief - Queues a task to run on a worker thread.
+     *
+     *  \param func - A callable that takes no arguments.
+     *  \return - A future holding the result of the task. If the task
+     *            throws, the exception is rethrown by future::get.
+     */
+    template <typename FuncT>
+    std::future<decltype(std::declval<FuncT&>()())> submit(FuncT func)
+    {
+        typedef decltype(std::declval<FuncT&>()()) ReturnT;
+        std::shared_ptr<std::packaged_task<ReturnT()> > task(
+                new std::packaged_task<ReturnT()>(std::move(func)));
+        std::future<ReturnT> ret = task->get_future();
+        push([task]()
+        {
+            (*task)();
+        });
+        return ret;
+    }
+
+    /*
+     *  \func - parallelFor
+     *  \brief - Splits the range [0, count) into contiguous chunks and runs
+     *           them across the workers and the calling thread. This
+     *           blocks until every chunk is done. It must not be called
+     *           from inside a task running on the same pool.
+     *
+     *  \param count - The number of items to process.
+     *  \param minChunk - The smallest number of items worth handing to
+     *         another thread. Small ranges run entirely on the caller.
+     *  \param func - Called as func(begin, end) for each chunk.
+     *  \throw - The first exception thrown by func, after every chunk has
+     *           finished.
+     */
+    template <typename FuncT>
+    void parallelFor(size_t count, size_t minChunk, FuncT func)
+    {
+        minChunk = std::max<size_t>(minChunk, 1);
+        const size_t numChunks = std::min(getNumThreads() + 1,
+                                          (count + minChunk - 1) / minChunk);
+        if (numChunks <= 1)
+        {
+            func(static_cast<size_t>(0), count);
+            return;
+        }
+
+        const size_t chunkSize = (count + numChunks - 1) / numChunks;
+        std::vector<std::future<void> > futures;
+        futures.reserve(numChunks);
+        for (size_t begin = chunkSize; begin < count; begin += chunkSize)
+        {
+            const size_t end = std::min(begin + chunkSize, count);
+            futures.push_back(submit([&func, begin, end]()
+            {
+                func(begin, end);
+            }));
+        }
+
+        // Every chunk must finish before returning because func may
+        // reference the caller's stack.
+        std::exception_ptr error;
+        try
+        {
+            func(static_cast<size_t>(0), chunkSize);
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+        for (size_t ii = 0; ii < futures.size(); ++ii)
+        {
+            try
+            {
+                futures[ii].get();
+            }
+            catch (...)
+            {
+                if (!error)
+                {
+                    error = std::current_exception();
+                }
+            }
+        }
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+
+    /*
+     *  \func - getNumThreads
+     *  \brief - Gets the number of worker threads.
+     */
+    size_t getNumThreads() const
+    {
+        return mThreads.size();
+    }
+
+    /*
+     *  \func - getNumPending
+     *  \brief - Gets the number of tasks that have not started yet.
+     */
+    size_t getNumPending();
+
+private:
+    void push(std::function<void()>&& task);
+
+    void run();
+
+    void stop();
+
+    std::vector<std::thread> mThreads;
+    std::queue<std::function<void()> > mTasks;
+    std::mutex mMutex;
+    std::condition_variable mCondition;
+    bool mStop;
+};
+}
+}
+
+#endif
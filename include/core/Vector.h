@@ -27,112 +27,168 @@
 #include <ostream>
 #include <algorithm>
 #include <array>
+#include <utility>
+#include <type_traits>
 #include <cmath>
 #include <core/Types.h>
 #include <core/Exception.h>
+#include <core/VectorKernels.h>
+#include <core/VectorExpression.h>
+
+/*
+ *  \def NYRA_CHECKED_VECTOR
+ *  \brief Enables range checks in Vector::atUnchecked. This is on by
+ *         default in debug builds.
+ */
+#if !defined(NDEBUG) && !defined(NYRA_CHECKED_VECTOR)
+#define NYRA_CHECKED_VECTOR
+#endif
 
 namespace nyra
 {
 namespace core
 {
 /*
- *  \class VectorElements
- *  \brief Base class for Vector. This is used to give simple variables
- *         to allow easy access to common sizes.
+ *  \class Vector
+ *  \brief A fixed size mathematical vector. The elements are stored
+ *         contiguously with nothing else so a Vector is exactly
+ *         sizeof(TypeT) * SizeT bytes and can be copied with memcpy.
+ *         Named access to the first four elements is provided by x(), y(),
+ *         z() and w(). Everything except length and normalize can be
+ *         evaluated at compile time so constant vectors can be constexpr.
  */
 template <typename TypeT, size_t SizeT>
-struct VectorElements
+struct Vector : public VectorExpression<Vector<TypeT, SizeT>, TypeT, SizeT>
 {
+    typedef TypeT Type;
+
+    constexpr Vector() :
+        mArray()
+    {
+    }
+
+    constexpr Vector(const Vector<TypeT, SizeT>& other) = default;
+
+    template <typename OtherT>
+    constexpr Vector(const Vector<OtherT, SizeT>& other) :
+        mArray()
+    {
+        for (size_t ii = 0; ii < SizeT; ++ii)
+        {
+            mArray[ii] = static_cast<TypeT>(other.getData()[ii]);
+        }
+    }
+
     /*
      *  \func Constructor
-     *  \brief Here for compatibility.
+     *  \brief Evaluates an arithmetic expression in a single pass.
      */
-    VectorElements(const std::array<TypeT, SizeT>& array)
+    template <typename ExpressionT>
+    constexpr Vector(
+            const VectorExpression<ExpressionT, TypeT, SizeT>& expression) :
+        mArray()
     {
+        assign(expression.derived());
     }
-};
 
-template <typename TypeT>
-struct VectorElements<TypeT, 2>
-{
-    VectorElements(std::array<TypeT, 2>& array) :
-        x(array[0]),
-        y(array[1])
+    constexpr Vector(const TypeT& x, const TypeT& y) :
+        mArray{{x, y}}
     {
+        static_assert(SizeT >= 2, "Too many elements for this Vector.");
     }
 
-    template <typename ThirdPartyT>
-    ThirdPartyT toThirdParty() const
+    constexpr Vector(const TypeT& x, const TypeT& y, const TypeT& z) :
+        mArray{{x, y, z}}
     {
-        return ThirdPartyT(x, y);
+        static_assert(SizeT >= 3, "Too many elements for this Vector.");
     }
 
-    TypeT& x;
-    TypeT& y;
-};
+    constexpr Vector(const TypeT& x,
+                     const TypeT& y,
+                     const TypeT& z,
+                     const TypeT& w) :
+        mArray{{x, y, z, w}}
+    {
+        static_assert(SizeT >= 4, "Too many elements for this Vector.");
+    }
 
-template <typename TypeT, size_t SizeT>
-struct Vector : public VectorElements<TypeT, SizeT>
-{
-    typedef TypeT Type;
+    constexpr Vector& operator=(const Vector<TypeT, SizeT>& rhs) = default;
 
-    Vector() :
-        VectorElements<TypeT, SizeT>(mArray)
+    template <typename ExpressionT>
+    constexpr Vector& operator=(const VectorExpression<ExpressionT, TypeT, SizeT>& rhs)
     {
-        std::fill(mArray.begin(), mArray.end(), 0);
+        // Each element only depends on the matching elements of the
+        // operands so this is safe even if the expression uses *this.
+        assign(rhs.derived());
+        return *this;
     }
 
-    Vector(const Vector<TypeT, SizeT>& other) :
-        VectorElements<TypeT, SizeT>(mArray)
+    constexpr TypeT& x()
     {
-        std::copy(other.getData().begin(),
-                          other.getData().end(),
-                          mArray.begin());
+        static_assert(SizeT > 0, "x() requires at least 1 element.");
+        return mArray[0];
     }
 
-    template <typename OtherT>
-    Vector(const Vector<OtherT, SizeT>& other) :
-        VectorElements<TypeT, SizeT>(mArray)
+    constexpr const TypeT& x() const
     {
-        std::copy(other.getData().begin(),
-                  other.getData().end(),
-                  mArray.begin());
+        static_assert(SizeT > 0, "x() requires at least 1 element.");
+        return mArray[0];
     }
 
-    Vector(const TypeT& x, const TypeT& y) :
-        VectorElements<TypeT, SizeT>(mArray)
+    constexpr TypeT& y()
     {
-        std::fill(mArray.begin(), mArray.end(), 0);
-        operator[](0) = x;
-        operator[](1) = y;
+        static_assert(SizeT > 1, "y() requires at least 2 elements.");
+        return mArray[1];
     }
 
-    Vector(const TypeT& x, const TypeT& y, const TypeT& z) :
-        VectorElements<TypeT, SizeT>(mArray)
+    constexpr const TypeT& y() const
     {
-        std::fill(mArray.begin(), mArray.end(), 0);
-        operator[](0) = x;
-        operator[](1) = y;
-        operator[](2) = z;
+        static_assert(SizeT > 1, "y() requires at least 2 elements.");
+        return mArray[1];
     }
 
-    Vector(const TypeT& x, const TypeT& y, const TypeT& z, const TypeT& w) :
-        VectorElements<TypeT, SizeT>(mArray)
+    constexpr TypeT& z()
     {
-        std::fill(mArray.begin(), mArray.end(), 0);
-        operator[](0) = x;
-        operator[](1) = y;
-        operator[](2) = z;
-        operator[](3) = w;
+        static_assert(SizeT > 2, "z() requires at least 3 elements.");
+        return mArray[2];
     }
 
-    Vector& operator=(const Vector<TypeT, SizeT>& rhs)
+    constexpr const TypeT& z() const
     {
-        mArray = rhs.mArray;
-        return *this;
+        static_assert(SizeT > 2, "z() requires at least 3 elements.");
+        return mArray[2];
+    }
+
+    constexpr TypeT& w()
+    {
+        static_assert(SizeT > 3, "w() requires at least 4 elements.");
+        return mArray[3];
+    }
+
+    constexpr const TypeT& w() const
+    {
+        static_assert(SizeT > 3, "w() requires at least 4 elements.");
+        return mArray[3];
+    }
+
+    /*
+     *  \func toThirdParty
+     *  \brief Converts to another library's vector type by passing every
+     *         element to its constructor in order.
+     */
+    template <typename ThirdPartyT>
+    constexpr ThirdPartyT toThirdParty() const
+    {
+        return toThirdParty<ThirdPartyT>(std::make_index_sequence<SizeT>());
     }
 
-    TypeT& operator[](size_t index)
+    /*
+     *  \func operator[]
+     *  \brief Accesses an element by index.
+     *
+     *  \throw Exception if the index is out of range.
+     */
+    constexpr TypeT& operator[](size_t index)
     {
         if (index >= SizeT)
         {
@@ -141,7 +197,7 @@ struct Vector : public VectorElements<TypeT, SizeT>
         return mArray[index];
     }
 
-    const TypeT& operator[](size_t index) const
+    constexpr const TypeT& operator[](size_t index) const
     {
         if (index >= SizeT)
         {
@@ -150,11 +206,79 @@ struct Vector : public VectorElements<TypeT, SizeT>
         return mArray[index];
     }
 
-    bool operator==(const Vector<TypeT, SizeT>& rhs)
+    /*
+     *  \func atUnchecked
+     *  \brief Accesses an element by index without a range check in
+     *         release builds. When NYRA_CHECKED_VECTOR is defined, which is
+     *         the default for debug builds, this checks the range like
+     *         operator[].
+     */
+    constexpr TypeT& atUnchecked(size_t index)
+    {
+#ifdef NYRA_CHECKED_VECTOR
+        return operator[](index);
+#else
+        return mArray[index];
+#endif
+    }
+
+    constexpr const TypeT& atUnchecked(size_t index) const
+    {
+#ifdef NYRA_CHECKED_VECTOR
+        return operator[](index);
+#else
+        return mArray[index];
+#endif
+    }
+
+    /*
+     *  \func get
+     *  \brief Accesses an element with an index that is checked at compile
+     *         time.
+     */
+    template <size_t IndexT>
+    constexpr TypeT& get()
+    {
+        static_assert(IndexT < SizeT, "Invalid index.");
+        return mArray[IndexT];
+    }
+
+    template <size_t IndexT>
+    constexpr const TypeT& get() const
+    {
+        static_assert(IndexT < SizeT, "Invalid index.");
+        return mArray[IndexT];
+    }
+
+    /*
+     *  \func evaluate
+     *  \brief Gets an element without a range check. This is used when
+     *         evaluating expressions.
+     */
+    constexpr TypeT evaluate(size_t index) const
+    {
+        return mArray[index];
+    }
+
+    /*
+     *  \func data
+     *  \brief Gets a pointer to the contiguous elements.
+     */
+    constexpr TypeT* data()
+    {
+        return mArray.data();
+    }
+
+    constexpr const TypeT* data() const
+    {
+        return mArray.data();
+    }
+
+    constexpr bool operator==(const Vector<TypeT, SizeT>& rhs) const
     {
         for (size_t ii = 0; ii < SizeT; ++ii)
         {
-            if (mArray[ii] != rhs[ii])
+            if (mArray[ii] != rhs.mArray[ii])
             {
                 return false;
             }
@@ -162,108 +286,178 @@ struct Vector : public VectorElements<TypeT, SizeT>
         return true;
     }
 
-    bool operator!=(const Vector<TypeT, SizeT>& rhs)
+    constexpr bool operator!=(const Vector<TypeT, SizeT>& rhs) const
     {
         return !operator==(rhs);
     }
 
-    Vector<TypeT, SizeT>& operator+=(const Vector<TypeT, SizeT>& rhs)
+    constexpr Vector<TypeT, SizeT>& operator+=(const Vector<TypeT, SizeT>& rhs)
+    {
+        VectorKernels<TypeT, SizeT>::add(mArray.data(), rhs.mArray.data());
+        return *this;
+    }
+
+    constexpr Vector<TypeT, SizeT>& operator-=(const Vector<TypeT, SizeT>& rhs)
+    {
+        VectorKernels<TypeT, SizeT>::subtract(mArray.data(), rhs.mArray.data());
+        return *this;
+    }
+
+    constexpr Vector<TypeT, SizeT>& operator*=(const Vector<TypeT, SizeT>& rhs)
+    {
+        VectorKernels<TypeT, SizeT>::multiply(mArray.data(), rhs.mArray.data());
+        return *this;
+    }
+
+    constexpr Vector<TypeT, SizeT>& operator/=(const Vector<TypeT, SizeT>& rhs)
+    {
+        VectorKernels<TypeT, SizeT>::divide(mArray.data(), rhs.mArray.data());
+        return *this;
+    }
+
+    template <typename ExpressionT>
+    constexpr Vector<TypeT, SizeT>& operator+=(
+            const VectorExpression<ExpressionT, TypeT, SizeT>& rhs)
     {
         for (size_t ii = 0; ii < SizeT; ++ii)
         {
-            mArray[ii] += rhs[ii];
+            mArray[ii] += rhs.derived().evaluate(ii);
         }
         return *this;
     }
 
-    Vector<TypeT, SizeT>& operator-=(const Vector<TypeT, SizeT>& rhs)
+    template <typename ScalarT, typename = typename std::enable_if<
+            IsVectorScalar<ScalarT>::value>::type>
+    constexpr Vector<TypeT, SizeT>& operator+=(const ScalarT& rhs)
     {
-        for (size_t ii = 0; ii < SizeT; ++ii)
+        unroll<SizeT>([this, rhs](size_t ii)
         {
-            mArray[ii] -= rhs[ii];
-        }
+            mArray[ii] += rhs;
+        });
         return *this;
     }
 
-    Vector<TypeT, SizeT>& operator*=(const Vector<TypeT, SizeT>& rhs)
+    template <typename ExpressionT>
+    constexpr Vector<TypeT, SizeT>& operator-=(
+            const VectorExpression<ExpressionT, TypeT, SizeT>& rhs)
     {
         for (size_t ii = 0; ii < SizeT; ++ii)
         {
-            mArray[ii] *= rhs[ii];
+            mArray[ii] -= rhs.derived().evaluate(ii);
         }
         return *this;
     }
 
-    Vector<TypeT, SizeT>& operator/=(const Vector<TypeT, SizeT>& rhs)
+    template <typename ScalarT, typename = typename std::enable_if<
+            IsVectorScalar<ScalarT>::value>::type>
+    constexpr Vector<TypeT, SizeT>& operator-=(const ScalarT& rhs)
     {
-        for (size_t ii = 0; ii < SizeT; ++ii)
+        unroll<SizeT>([this, rhs](size_t ii)
         {
-            mArray[ii] /= rhs[ii];
-        }
+            mArray[ii] -= rhs;
+        });
         return *this;
     }
 
-    template <typename ScalarT>
-    Vector<TypeT, SizeT>& operator+=(const ScalarT& rhs)
+    template <typename ExpressionT>
+    constexpr Vector<TypeT, SizeT>& operator*=(
+            const VectorExpression<ExpressionT, TypeT, SizeT>& rhs)
     {
         for (size_t ii = 0; ii < SizeT; ++ii)
         {
-            mArray[ii] += rhs;
+            mArray[ii] *= rhs.derived().evaluate(ii);
         }
         return *this;
     }
 
-    template <typename ScalarT>
-    Vector<TypeT, SizeT>& operator-=(const ScalarT& rhs)
+    template <typename ScalarT, typename = typename std::enable_if<
+            IsVectorScalar<ScalarT>::value>::type>
+    constexpr Vector<TypeT, SizeT>& operator*=(const ScalarT& rhs)
+    {
+        unroll<SizeT>([this, rhs](size_t ii)
+        {
+            mArray[ii] *= rhs;
+        });
+        return *this;
+    }
+
+    template <typename ExpressionT>
+    constexpr Vector<TypeT, SizeT>& operator/=(
+            const VectorExpression<ExpressionT, TypeT, SizeT>& rhs)
     {
         for (size_t ii = 0; ii < SizeT; ++ii)
         {
-            mArray[ii] -= rhs;
+            mArray[ii] /= rhs.derived().evaluate(ii);
         }
         return *this;
     }
 
-    template <typename ScalarT>
-    Vector<TypeT, SizeT>& operator*=(const ScalarT& rhs)
+    template <typename ScalarT, typename = typename std::enable_if<
+            IsVectorScalar<ScalarT>::value>::type>
+    constexpr Vector<TypeT, SizeT>& operator/=(const ScalarT& rhs)
     {
+        unroll<SizeT>([this, rhs](size_t ii)
+        {
+            mArray[ii] /= rhs;
+        });
+        return *this;
+    }
+
+    constexpr TypeT productOfElements() const
+    {
+        TypeT ret = static_cast<TypeT>(1);
         for (size_t ii = 0; ii < SizeT; ++ii)
         {
-            mArray[ii] *= rhs;
+            ret *= mArray[ii];
         }
-        return *this;
+        return ret;
     }
 
-    template <typename ScalarT>
-    Vector<TypeT, SizeT>& operator/=(const ScalarT& rhs)
+    constexpr TypeT sumOfElements() const
     {
+        TypeT ret = static_cast<TypeT>(0);
         for (size_t ii = 0; ii < SizeT; ++ii)
         {
-            mArray[ii] /= rhs;
+            ret += mArray[ii];
         }
-        return *this;
+        return ret;
     }
 
-    TypeT productOfElements() const
+    constexpr TypeT sumOfSquares() const
     {
-        return std::accumulate(mArray.begin(),
-                               mArray.end(),
-                               1,
-                               std::multiplies<TypeT>());
+        return dot(*this);
     }
 
-    TypeT sumOfElements() const
+    /*
+     *  \func dot
+     *  \brief Computes the dot product with another vector.
+     */
+    constexpr TypeT dot(const Vector<TypeT, SizeT>& rhs) const
+    {
+        return VectorKernels<TypeT, SizeT>::dot(mArray.data(),
+                                                rhs.mArray.data());
+    }
+
+    /*
+     *  \func minimize
+     *  \brief Sets each element to the smaller of itself and the matching
+     *         element of another vector.
+     */
+    constexpr Vector<TypeT, SizeT>& minimize(const Vector<TypeT, SizeT>& rhs)
     {
-        return std::accumulate(mArray.begin(),
-                               mArray.end(),
-                               0);
+        VectorKernels<TypeT, SizeT>::minimum(mArray.data(), rhs.mArray.data());
+        return *this;
     }
 
-    TypeT sumOfSquares() const
+    /*
+     *  \func maximize
+     *  \brief Sets each element to the larger of itself and the matching
+     *         element of another vector.
+     */
+    constexpr Vector<TypeT, SizeT>& maximize(const Vector<TypeT, SizeT>& rhs)
     {
-        return std::inner_product(mArray.begin(),
-                                  mArray.end(),
-                                  mArray.begin(),
-                                  0);
+        VectorKernels<TypeT, SizeT>::maximum(mArray.data(), rhs.mArray.data());
+        return *this;
     }
 
     double length() const
@@ -271,109 +465,90 @@ struct Vector : public VectorElements<TypeT, SizeT>
         return std::sqrt(lengthSquared());
     }
 
-    double lengthSquared() const
+    constexpr double lengthSquared() const
     {
         return static_cast<double>(sumOfSquares());
     }
 
-    void normilize()
+    void normalize()
     {
         *this /= length();
     }
 
-    const std::array<TypeT, SizeT>& getData() const
+    /*
+     *  \func normilize
+     *  \brief Deprecated spelling of normalize.
+     */
+    void normilize()
+    {
+        normalize();
+    }
+
+    constexpr const std::array<TypeT, SizeT>& getData() const
     {
         return mArray;
     }
 
 private:
+    template <typename ExpressionT>
+    constexpr void assign(const ExpressionT& expression)
+    {
+        for (size_t ii = 0; ii < SizeT; ++ii)
+        {
+            mArray[ii] = expression.evaluate(ii);
+        }
+    }
+
+    template <typename ThirdPartyT, size_t... IndicesT>
+    constexpr ThirdPartyT toThirdParty(std::index_sequence<IndicesT...>) const
+    {
+        return ThirdPartyT(mArray[IndicesT]...);
+    }
+
     std::array<TypeT, SizeT> mArray;
 };
 
 template <typename TypeT, size_t SizeT>
-inline Vector<TypeT, SizeT> operator+(
-        Vector<TypeT, SizeT> lhs,
-        const Vector<TypeT, SizeT>& rhs)
+constexpr TypeT dot(const Vector<TypeT, SizeT>& lhs,
+                    const Vector<TypeT, SizeT>& rhs)
 {
-    lhs += rhs;
-    return lhs;
+    return lhs.dot(rhs);
 }
 
 template <typename TypeT, size_t SizeT>
-inline Vector<TypeT, SizeT> operator-(
-        Vector<TypeT, SizeT> lhs,
-        const Vector<TypeT, SizeT>& rhs)
+constexpr Vector<TypeT, SizeT> minimum(Vector<TypeT, SizeT> lhs,
+                                       const Vector<TypeT, SizeT>& rhs)
 {
-    lhs -= rhs;
-    return lhs;
+    return lhs.minimize(rhs);
 }
 
 template <typename TypeT, size_t SizeT>
-inline Vector<TypeT, SizeT> operator*(
-        Vector<TypeT, SizeT> lhs,
-        const Vector<TypeT, SizeT>& rhs)
+constexpr Vector<TypeT, SizeT> maximum(Vector<TypeT, SizeT> lhs,
+                                       const Vector<TypeT, SizeT>& rhs)
 {
-    lhs *= rhs;
-    return lhs;
+    return lhs.maximize(rhs);
 }
 
 template <typename TypeT, size_t SizeT>
-inline Vector<TypeT, SizeT> operator/(
-        Vector<TypeT, SizeT> lhs,
-        const Vector<TypeT, SizeT>& rhs)
+inline Vector<TypeT, SizeT> normalize(Vector<TypeT, SizeT> vector)
 {
-    lhs /= rhs;
-    return lhs;
+    vector.normalize();
+    return vector;
 }
 
-template <typename TypeT, size_t SizeT, typename ScalarT>
-inline Vector<TypeT, SizeT> operator+(
-        Vector<TypeT, SizeT> lhs,
-        const ScalarT& rhs)
-{
-    lhs += rhs;
-    return lhs;
-}
-template <typename TypeT, size_t SizeT, typename ScalarT>
-inline Vector<TypeT, SizeT> operator-(
-        Vector<TypeT, SizeT> lhs,
-        const ScalarT& rhs)
-{
-    lhs -= rhs;
-    return lhs;
-}
-
-template <typename TypeT, size_t SizeT, typename ScalarT>
-inline Vector<TypeT, SizeT> operator*(
-        Vector<TypeT, SizeT> lhs,
-        const ScalarT& rhs)
-{
-    lhs *= rhs;
-    return lhs;
-}
-
-template <typename TypeT, size_t SizeT, typename ScalarT>
-inline Vector<TypeT, SizeT> operator/(
-        Vector<TypeT, SizeT> lhs,
-        const ScalarT& rhs)
-{
-    lhs /= rhs;
-    return lhs;
-}
-
-template <typename TypeT, size_t SizeT>
+template <typename ExpressionT, typename TypeT, size_t SizeT>
 std::ostream& operator<<(std::ostream& os,
-                         const Vector<TypeT, SizeT>& vector)
+                         const VectorExpression<ExpressionT, TypeT, SizeT>& vector)
 {
     if (!SizeT)
     {
         return os;
     }
 
-    os << "(" << vector[0];
+    os << "(" << vector.derived().evaluate(0);
     for (size_t ii = 1; ii < SizeT; ++ii)
     {
-        os << ", " << vector[ii];
+        os << ", " << vector.derived().evaluate(ii);
     }
     os << ")";
     return os;
@@ -382,6 +557,22 @@ std::ostream& operator<<(std::ostream& os,
 typedef Vector<float, 2> Vector2F;
 typedef Vector<size_t, 2> Vector2UI;
 typedef Vector<ssize_t, 2> Vector2I;
+typedef Vector<float, 3> Vector3F;
+typedef Vector<float, 4> Vector4F;
+typedef Vector<int32_t, 4> Vector4I;
+
+// Vectors are stored in bulk so they must not carry anything besides their
+// elements and must be safe to copy with memcpy.
+static_assert(sizeof(Vector2F) == sizeof(float) * 2,
+              "Vector2F must only contain its elements.");
+static_assert(sizeof(Vector2UI) == sizeof(size_t) * 2,
+              "Vector2UI must only contain its elements.");
+static_assert(sizeof(Vector2I) == sizeof(ssize_t) * 2,
+              "Vector2I must only contain its elements.");
+static_assert(std::is_standard_layout<Vector2F>::value,
+              "Vector must be standard layout.");
+static_assert(std::is_trivially_copyable<Vector2F>::value,
+              "Vector must be trivially copyable.");
 
 }
 }
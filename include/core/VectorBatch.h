@@ -0,0 +1,531 @@
+/******************************************************************************
+ * The MIT License(MIT)
+ *
+ * Copyright(c) 2015 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+#ifndef __NYRA_CORE_VECTOR_BATCH_H__
+#define __NYRA_CORE_VECTOR_BATCH_H__
+
+#include <vector>
+#include <array>
+#include <mutex>
+#include <cmath>
+#include <algorithm>
+#include <type_traits>
+#include <core/Vector.h>
+#include <core/VectorKernels.h>
+#include <core/AlignedAllocator.h>
+#include <core/ThreadPool.h>
+#include <core/Exception.h>
+
+namespace nyra
+{
+namespace core
+{
+/*
+ *  \class VectorBatch
+ *  \brief Stores many vectors as a structure of arrays. Each component
+ *         (all of the x values, all of the y values, ...) is kept in its own
+ *         contiguous, aligned array so bulk operations run across whole
+ *         SIMD registers instead of one vector at a time. If a ThreadPool is
+ *         set, large batches are also split across its workers.
+ *
+ *  \param TypeT The type of each component.
+ *  \param SizeT The number of components in each vector.
+ */
+template <typename TypeT, size_t SizeT>
+class VectorBatch
+{
+public:
+    typedef Vector<TypeT, SizeT> VectorT;
+    typedef std::vector<TypeT, AlignedAllocator<TypeT> > ComponentArray;
+
+    /*
+     *  \func Constructor
+     *  \brief Creates a batch of zero vectors.
+     *
+     *  \param size The number of vectors.
+     */
+    explicit VectorBatch(size_t size = 0) :
+        mPool(nullptr)
+    {
+        resize(size);
+    }
+
+    /*
+     *  \func Constructor
+     *  \brief Creates a batch from an array of vectors.
+     *
+     *  \param vectors The vectors to copy.
+     *  \param count The number of vectors.
+     */
+    VectorBatch(const VectorT* vectors, size_t count) :
+        mPool(nullptr)
+    {
+        assign(vectors, count);
+    }
+
+    /*
+     *  \func Constructor
+     *  \brief Creates a batch from an array of vectors.
+     *
+     *  \param vectors The vectors to copy.
+     */
+    explicit VectorBatch(const std::vector<VectorT>& vectors) :
+        mPool(nullptr)
+    {
+        assign(vectors.data(), vectors.size());
+    }
+
+    /*
+     *  \func setThreadPool
+     *  \brief Sets the workers used to split large operations. Pass nullptr
+     *         to run everything on the calling thread.
+     */
+    void setThreadPool(ThreadPool* pool)
+    {
+        mPool = pool;
+    }
+
+    size_t size() const
+    {
+        return mComponents[0].size();
+    }
+
+    bool empty() const
+    {
+        return mComponents[0].empty();
+    }
+
+    void resize(size_t size)
+    {
+        for (size_t ii = 0; ii < SizeT; ++ii)
+        {
+            mComponents[ii].resize(size, static_cast<TypeT>(0));
+        }
+    }
+
+    void reserve(size_t size)
+    {
+        for (size_t ii = 0; ii < SizeT; ++ii)
+        {
+            mComponents[ii].reserve(size);
+        }
+    }
+
+    void clear()
+    {
+        for (size_t ii = 0; ii < SizeT; ++ii)
+        {
+            mComponents[ii].clear();
+        }
+    }
+
+    void pushBack(const VectorT& vector)
+    {
+        for (size_t ii = 0; ii < SizeT; ++ii)
+        {
+            mComponents[ii].push_back(vector.data()[ii]);
+        }
+    }
+
+    /*
+     *  \func getComponent
+     *  \brief Gets the contiguous array holding one component of every
+     *         vector. The array is aligned to 64 bytes.
+     */
+    TypeT* getComponent(size_t component)
+    {
+        return mComponents[component].data();
+    }
+
+    const TypeT* getComponent(size_t component) const
+    {
+        return mComponents[component].data();
+    }
+
+    VectorT get(size_t index) const
+    {
+        VectorT ret;
+        for (size_t ii = 0; ii < SizeT; ++ii)
+        {
+            ret.data()[ii] = mComponents[ii][index];
+        }
+        return ret;
+    }
+
+    void set(size_t index, const VectorT& vector)
+    {
+        for (size_t ii = 0; ii < SizeT; ++ii)
+        {
+            mComponents[ii][index] = vector.data()[ii];
+        }
+    }
+
+    /*
+     *  \func assign
+     *  \brief Replaces the batch with a copy of an array of vectors.
+     */
+    void assign(const VectorT* vectors, size_t count)
+    {
+        resize(count);
+        for (size_t ii = 0; ii < SizeT; ++ii)
+        {
+            TypeT* out = mComponents[ii].data();
+            for (size_t jj = 0; jj < count; ++jj)
+            {
+                out[jj] = vectors[jj].data()[ii];
+            }
+        }
+    }
+
+    /*
+     *  \func toVectors
+     *  \brief Copies the batch into an array of vectors.
+     *
+     *  \param out [OUTPUT] The vectors. This must hold size() vectors.
+     */
+    void toVectors(VectorT* out) const
+    {
+        for (size_t ii = 0; ii < SizeT; ++ii)
+        {
+            const TypeT* in = mComponents[ii].data();
+            for (size_t jj = 0; jj < size(); ++jj)
+            {
+                out[jj].data()[ii] = in[jj];
+            }
+        }
+    }
+
+    std::vector<VectorT> toVectors() const
+    {
+        std::vector<VectorT> ret(size());
+        toVectors(ret.data());
+        return ret;
+    }
+
+    /*
+     *  \func add
+     *  \brief Adds each vector of another batch to the matching vector.
+     *
+     *  \throw Exception if the batches are different sizes.
+     */
+    void add(const VectorBatch<TypeT, SizeT>& rhs)
+    {
+        checkSize(rhs);
+        run([this, &rhs](size_t begin, size_t end)
+        {
+            for (size_t ii = 0; ii < SizeT; ++ii)
+            {
+                TypeT* lhsData = mComponents[ii].data();
+                const TypeT* rhsData = rhs.mComponents[ii].data();
+                for (size_t jj = begin; jj < end; ++jj)
+                {
+                    lhsData[jj] += rhsData[jj];
+                }
+            }
+        });
+    }
+
+    /*
+     *  \func add
+     *  \brief Adds the same offset to every vector.
+     */
+    void add(const VectorT& offset)
+    {
+        run([this, &offset](size_t begin, size_t end)
+        {
+            for (size_t ii = 0; ii < SizeT; ++ii)
+            {
+                TypeT* data = mComponents[ii].data();
+                const TypeT value = offset.data()[ii];
+                for (size_t jj = begin; jj < end; ++jj)
+                {
+                    data[jj] += value;
+                }
+            }
+        });
+    }
+
+    /*
+     *  \func scale
+     *  \brief Multiplies every vector by a scalar.
+     */
+    void scale(TypeT scalar)
+    {
+        run([this, scalar](size_t begin, size_t end)
+        {
+            for (size_t ii = 0; ii < SizeT; ++ii)
+            {
+                TypeT* data = mComponents[ii].data();
+                for (size_t jj = begin; jj < end; ++jj)
+                {
+                    data[jj] *= scalar;
+                }
+            }
+        });
+    }
+
+    /*
+     *  \func scale
+     *  \brief Multiplies every vector by another vector, element-wise.
+     */
+    void scale(const VectorT& scalar)
+    {
+        run([this, &scalar](size_t begin, size_t end)
+        {
+            for (size_t ii = 0; ii < SizeT; ++ii)
+            {
+                TypeT* data = mComponents[ii].data();
+                const TypeT value = scalar.data()[ii];
+                for (size_t jj = begin; jj < end; ++jj)
+                {
+                    data[jj] *= value;
+                }
+            }
+        });
+    }
+
+    /*
+     *  \func dot
+     *  \brief Computes the dot product of each vector with the matching
+     *         vector of another batch.
+     *
+     *  \param rhs The other batch.
+     *  \param out [OUTPUT] One result per vector. This must hold size()
+     *             values.
+     *  \throw Exception if the batches are different sizes.
+     */
+    void dot(const VectorBatch<TypeT, SizeT>& rhs, TypeT* out) const
+    {
+        checkSize(rhs);
+        run([this, &rhs, out](size_t begin, size_t end)
+        {
+            dotRange(mComponents, rhs.mComponents, out + begin, begin, end);
+        });
+    }
+
+    /*
+     *  \func length
+     *  \brief Computes the length of every vector.
+     *
+     *  \param out [OUTPUT] One result per vector. This must hold size()
+     *             values.
+     */
+    void length(TypeT* out) const
+    {
+        run([this, out](size_t begin, size_t end)
+        {
+            dotRange(mComponents, mComponents, out + begin, begin, end);
+            squareRoot(out + begin, end - begin);
+        });
+    }
+
+    /*
+     *  \func normalize
+     *  \brief Scales every vector to a length of 1. Zero length vectors are
+     *         left as zero.
+     */
+    void normalize()
+    {
+        run([this](size_t begin, size_t end)
+        {
+            // Work in blocks so the lengths fit on the stack.
+            TypeT lengths[256];
+            for (size_t block = begin; block < end; block += 256)
+            {
+                const size_t blockEnd = std::min<size_t>(block + 256, end);
+                dotRange(mComponents, mComponents, lengths, block, blockEnd);
+                squareRoot(lengths, blockEnd - block);
+
+                for (size_t ii = 0; ii < SizeT; ++ii)
+                {
+                    TypeT* data = mComponents[ii].data() + block;
+                    for (size_t jj = 0; jj < blockEnd - block; ++jj)
+                    {
+                        data[jj] = lengths[jj] == static_cast<TypeT>(0) ?
+                                static_cast<TypeT>(0) :
+                                data[jj] / lengths[jj];
+                    }
+                }
+            }
+        });
+    }
+
+    /*
+     *  \func distance
+     *  \brief Computes the distance from every vector to a point.
+     *
+     *  \param point The point to measure from.
+     *  \param out [OUTPUT] One result per vector. This must hold size()
+     *             values.
+     */
+    void distance(const VectorT& point, TypeT* out) const
+    {
+        run([this, &point, out](size_t begin, size_t end)
+        {
+            std::fill(out + begin, out + end, static_cast<TypeT>(0));
+            for (size_t ii = 0; ii < SizeT; ++ii)
+            {
+                const TypeT* data = mComponents[ii].data();
+                const TypeT value = point.data()[ii];
+                for (size_t jj = begin; jj < end; ++jj)
+                {
+                    const TypeT delta = data[jj] - value;
+                    out[jj] += delta * delta;
+                }
+            }
+            squareRoot(out + begin, end - begin);
+        });
+    }
+
+    /*
+     *  \func bounds
+     *  \brief Computes the axis aligned bounding box of every vector.
+     *
+     *  \param min [OUTPUT] The smallest value of each component.
+     *  \param max [OUTPUT] The largest value of each component.
+     *  \throw Exception if the batch is empty.
+     */
+    void bounds(VectorT& min, VectorT& max) const
+    {
+        if (empty())
+        {
+            throw Exception("Cannot compute the bounds of an empty batch.");
+        }
+
+        min = get(0);
+        max = min;
+        std::mutex mutex;
+        run([this, &min, &max, &mutex](size_t begin, size_t end)
+        {
+            VectorT localMin = get(begin);
+            VectorT localMax = localMin;
+            for (size_t ii = 0; ii < SizeT; ++ii)
+            {
+                const TypeT* data = mComponents[ii].data();
+                TypeT low = localMin.data()[ii];
+                TypeT high = low;
+                for (size_t jj = begin; jj < end; ++jj)
+                {
+                    low = data[jj] < low ? data[jj] : low;
+                    high = data[jj] > high ? data[jj] : high;
+                }
+                localMin.data()[ii] = low;
+                localMax.data()[ii] = high;
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            min.minimize(localMin);
+            max.maximize(localMax);
+        });
+    }
+
+private:
+    typedef std::array<ComponentArray, SizeT> Components;
+
+    template <typename FuncT>
+    void run(FuncT func) const
+    {
+        if (empty())
+        {
+            return;
+        }
+
+        if (mPool)
+        {
+            mPool->parallelFor(size(), 65536, func);
+        }
+        else
+        {
+            func(static_cast<size_t>(0), size());
+        }
+    }
+
+    void checkSize(const VectorBatch<TypeT, SizeT>& rhs) const
+    {
+        if (size() != rhs.size())
+        {
+            throw Exception("Vector batches must be the same size.");
+        }
+    }
+
+    /*
+     *  Writes the dot products of vectors [begin, end) to out, where out[0]
+     *  is the result for begin.
+     */
+    static void dotRange(const Components& lhs,
+                         const Components& rhs,
+                         TypeT* out,
+                         size_t begin,
+                         size_t end)
+    {
+        const size_t count = end - begin;
+        std::fill(out, out + count, static_cast<TypeT>(0));
+        for (size_t ii = 0; ii < SizeT; ++ii)
+        {
+            const TypeT* lhsData = lhs[ii].data() + begin;
+            const TypeT* rhsData = rhs[ii].data() + begin;
+            for (size_t jj = 0; jj < count; ++jj)
+            {
+                out[jj] += lhsData[jj] * rhsData[jj];
+            }
+        }
+    }
+
+    static void squareRoot(TypeT* data, size_t count)
+    {
+        size_t ii = 0;
+#ifdef NYRA_VECTOR_SSE2
+        // std::sqrt can set errno which stops compilers from vectorizing
+        // it, so float and double use the SIMD instruction directly.
+        if constexpr (std::is_same<TypeT, float>::value)
+        {
+            for (; ii + 4 <= count; ii += 4)
+            {
+                _mm_storeu_ps(data + ii, _mm_sqrt_ps(_mm_loadu_ps(data + ii)));
+            }
+        }
+        else if constexpr (std::is_same<TypeT, double>::value)
+        {
+            for (; ii + 2 <= count; ii += 2)
+            {
+                _mm_storeu_pd(data + ii, _mm_sqrt_pd(_mm_loadu_pd(data + ii)));
+            }
+        }
+#endif
+        for (; ii < count; ++ii)
+        {
+            data[ii] = static_cast<TypeT>(std::sqrt(data[ii]));
+        }
+    }
+
+    Components mComponents;
+    ThreadPool* mPool;
+};
+
+typedef VectorBatch<float, 2> VectorBatch2F;
+typedef VectorBatch<float, 3> VectorBatch3F;
+typedef VectorBatch<float, 4> VectorBatch4F;
+}
+}
+
+#endif
@@ -0,0 +1,325 @@
+/******************************************************************************
+ * The MIT License(MIT)
+ *
+ * Copyright(c) 2015 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+#ifndef __NYRA_CORE_VECTOR_EXPRESSION_H__
+#define __NYRA_CORE_VECTOR_EXPRESSION_H__
+
+#include <stddef.h>
+#include <cmath>
+#include <type_traits>
+
+namespace nyra
+{
+namespace core
+{
+template <typename TypeT, size_t SizeT>
+struct Vector;
+
+/*
+ *  \class VectorExpression
+ *  \brief Base class for anything that produces the elements of a Vector.
+ *         The arithmetic operators return lightweight expression objects
+ *         instead of new Vectors, so an expression like a + b * s - c is
+ *         only evaluated once it is assigned to a Vector. This runs a
+ *         single loop with no temporaries.
+ *
+ *         Expressions hold references to the Vectors they use. Store the
+ *         result in a Vector, not in an auto variable, if the operands may
+ *         go out of scope first.
+ *
+ *  \param DerivedT The expression type (CRTP).
+ *  \param TypeT The element type.
+ *  \param SizeT The number of elements.
+ */
+template <typename DerivedT, typename TypeT, size_t SizeT>
+struct VectorExpression
+{
+    typedef TypeT Type;
+
+    constexpr const DerivedT& derived() const
+    {
+        return static_cast<const DerivedT&>(*this);
+    }
+
+    /*
+     *  \func eval
+     *  \brief Evaluates the expression into a Vector.
+     */
+    constexpr Vector<TypeT, SizeT> eval() const
+    {
+        return Vector<TypeT, SizeT>(*this);
+    }
+
+    constexpr TypeT sumOfElements() const
+    {
+        return eval().sumOfElements();
+    }
+
+    constexpr TypeT productOfElements() const
+    {
+        return eval().productOfElements();
+    }
+
+    constexpr TypeT sumOfSquares() const
+    {
+        return eval().sumOfSquares();
+    }
+
+    double length() const
+    {
+        return eval().length();
+    }
+
+    constexpr double lengthSquared() const
+    {
+        return eval().lengthSquared();
+    }
+};
+
+/*
+ *  \class VectorOperand
+ *  \brief Decides how an expression stores its operands. Vectors are held
+ *         by reference so they are not copied. Other expressions are small
+ *         temporaries so they are held by value.
+ */
+template <typename ExpressionT>
+struct VectorOperand
+{
+    typedef const ExpressionT type;
+};
+
+template <typename TypeT, size_t SizeT>
+struct VectorOperand<Vector<TypeT, SizeT> >
+{
+    typedef const Vector<TypeT, SizeT>& type;
+};
+
+struct VectorAdd
+{
+    template <typename LhsT, typename RhsT>
+    static constexpr auto apply(const LhsT& lhs, const RhsT& rhs)
+    {
+        return lhs + rhs;
+    }
+};
+
+struct VectorSubtract
+{
+    template <typename LhsT, typename RhsT>
+    static constexpr auto apply(const LhsT& lhs, const RhsT& rhs)
+    {
+        return lhs - rhs;
+    }
+};
+
+struct VectorMultiply
+{
+    template <typename LhsT, typename RhsT>
+    static constexpr auto apply(const LhsT& lhs, const RhsT& rhs)
+    {
+        return lhs * rhs;
+    }
+};
+
+struct VectorDivide
+{
+    template <typename LhsT, typename RhsT>
+    static constexpr auto apply(const LhsT& lhs, const RhsT& rhs)
+    {
+        return lhs / rhs;
+    }
+};
+
+/*
+ *  \class VectorBinaryExpression
+ *  \brief Applies an operation to the matching elements of two expressions.
+ */
+template <typename LhsT, typename RhsT, typename OperationT,
+          typename TypeT, size_t SizeT>
+struct VectorBinaryExpression : public VectorExpression<
+        VectorBinaryExpression<LhsT, RhsT, OperationT, TypeT, SizeT>,
+        TypeT, SizeT>
+{
+    constexpr VectorBinaryExpression(const LhsT& lhs, const RhsT& rhs) :
+        mLhs(lhs),
+        mRhs(rhs)
+    {
+    }
+
+    constexpr TypeT evaluate(size_t index) const
+    {
+        return static_cast<TypeT>(OperationT::apply(mLhs.evaluate(index),
+                                                    mRhs.evaluate(index)));
+    }
+
+private:
+    typename VectorOperand<LhsT>::type mLhs;
+    typename VectorOperand<RhsT>::type mRhs;
+};
+
+/*
+ *  \class VectorScalarExpression
+ *  \brief Applies an operation to every element of an expression and a
+ *         scalar.
+ */
+template <typename ExpressionT, typename ScalarT, typename OperationT,
+          typename TypeT, size_t SizeT>
+struct VectorScalarExpression : public VectorExpression<
+        VectorScalarExpression<ExpressionT, ScalarT, OperationT, TypeT, SizeT>,
+        TypeT, SizeT>
+{
+    constexpr VectorScalarExpression(const ExpressionT& expression,
+                                     const ScalarT& scalar) :
+        mExpression(expression),
+        mScalar(scalar)
+    {
+    }
+
+    constexpr TypeT evaluate(size_t index) const
+    {
+        return static_cast<TypeT>(OperationT::apply(
+                mExpression.evaluate(index), mScalar));
+    }
+
+private:
+    typename VectorOperand<ExpressionT>::type mExpression;
+    const ScalarT mScalar;
+};
+
+/*
+ *  \class IsVectorScalar
+ *  \brief Limits the scalar operators to arithmetic types so they do not
+ *         compete with the vector operators.
+ */
+template <typename ScalarT>
+struct IsVectorScalar : std::is_arithmetic<ScalarT>
+{
+};
+
+template <typename LhsT, typename RhsT, typename TypeT, size_t SizeT>
+constexpr VectorBinaryExpression<LhsT, RhsT, VectorAdd, TypeT, SizeT>
+operator+(const VectorExpression<LhsT, TypeT, SizeT>& lhs,
+          const VectorExpression<RhsT, TypeT, SizeT>& rhs)
+{
+    return VectorBinaryExpression<LhsT, RhsT, VectorAdd, TypeT, SizeT>(
+            lhs.derived(), rhs.derived());
+}
+
+template <typename LhsT, typename RhsT, typename TypeT, size_t SizeT>
+constexpr VectorBinaryExpression<LhsT, RhsT, VectorSubtract, TypeT, SizeT>
+operator-(const VectorExpression<LhsT, TypeT, SizeT>& lhs,
+          const VectorExpression<RhsT, TypeT, SizeT>& rhs)
+{
+    return VectorBinaryExpression<LhsT, RhsT, VectorSubtract, TypeT, SizeT>(
+            lhs.derived(), rhs.derived());
+}
+
+template <typename LhsT, typename RhsT, typename TypeT, size_t SizeT>
+constexpr VectorBinaryExpression<LhsT, RhsT, VectorMultiply, TypeT, SizeT>
+operator*(const VectorExpression<LhsT, TypeT, SizeT>& lhs,
+          const VectorExpression<RhsT, TypeT, SizeT>& rhs)
+{
+    return VectorBinaryExpression<LhsT, RhsT, VectorMultiply, TypeT, SizeT>(
+            lhs.derived(), rhs.derived());
+}
+
+template <typename LhsT, typename RhsT, typename TypeT, size_t SizeT>
+constexpr VectorBinaryExpression<LhsT, RhsT, VectorDivide, TypeT, SizeT>
+operator/(const VectorExpression<LhsT, TypeT, SizeT>& lhs,
+          const VectorExpression<RhsT, TypeT, SizeT>& rhs)
+{
+    return VectorBinaryExpression<LhsT, RhsT, VectorDivide, TypeT, SizeT>(
+            lhs.derived(), rhs.derived());
+}
+
+template <typename ExpressionT, typename TypeT, size_t SizeT,
+          typename ScalarT, typename = typename std::enable_if<
+                  IsVectorScalar<ScalarT>::value>::type>
+constexpr VectorScalarExpression<ExpressionT, ScalarT, VectorAdd, TypeT, SizeT>
+operator+(const VectorExpression<ExpressionT, TypeT, SizeT>& lhs,
+          const ScalarT& rhs)
+{
+    return VectorScalarExpression<ExpressionT, ScalarT, VectorAdd,
+                                  TypeT, SizeT>(lhs.derived(), rhs);
+}
+
+template <typename ExpressionT, typename TypeT, size_t SizeT,
+          typename ScalarT, typename = typename std::enable_if<
+                  IsVectorScalar<ScalarT>::value>::type>
+constexpr VectorScalarExpression<ExpressionT, ScalarT, VectorSubtract,
+                              TypeT, SizeT>
+operator-(const VectorExpression<ExpressionT, TypeT, SizeT>& lhs,
+          const ScalarT& rhs)
+{
+    return VectorScalarExpression<ExpressionT, ScalarT, VectorSubtract,
+                                  TypeT, SizeT>(lhs.derived(), rhs);
+}
+
+template <typename ExpressionT, typename TypeT, size_t SizeT,
+          typename ScalarT, typename = typename std::enable_if<
+                  IsVectorScalar<ScalarT>::value>::type>
+constexpr VectorScalarExpression<ExpressionT, ScalarT, VectorMultiply,
+                              TypeT, SizeT>
+operator*(const VectorExpression<ExpressionT, TypeT, SizeT>& lhs,
+          const ScalarT& rhs)
+{
+    return VectorScalarExpression<ExpressionT, ScalarT, VectorMultiply,
+                                  TypeT, SizeT>(lhs.derived(), rhs);
+}
+
+template <typename ExpressionT, typename TypeT, size_t SizeT,
+          typename ScalarT, typename = typename std::enable_if<
+                  IsVectorScalar<ScalarT>::value>::type>
+constexpr VectorScalarExpression<ExpressionT, ScalarT, VectorDivide,
+                              TypeT, SizeT>
+operator/(const VectorExpression<ExpressionT, TypeT, SizeT>& lhs,
+          const ScalarT& rhs)
+{
+    return VectorScalarExpression<ExpressionT, ScalarT, VectorDivide,
+                                  TypeT, SizeT>(lhs.derived(), rhs);
+}
+
+template <typename LhsT, typename RhsT, typename TypeT, size_t SizeT>
+constexpr bool operator==(const VectorExpression<LhsT, TypeT, SizeT>& lhs,
+                          const VectorExpression<RhsT, TypeT, SizeT>& rhs)
+{
+    for (size_t ii = 0; ii < SizeT; ++ii)
+    {
+        if (lhs.derived().evaluate(ii) != rhs.derived().evaluate(ii))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename LhsT, typename RhsT, typename TypeT, size_t SizeT>
+constexpr bool operator!=(const VectorExpression<LhsT, TypeT, SizeT>& lhs,
+                          const VectorExpression<RhsT, TypeT, SizeT>& rhs)
+{
+    return !(lhs == rhs);
+}
+}
+}
+
+#endif
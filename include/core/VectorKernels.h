@@ -0,0 +1,549 @@
+/******************************************************************************
+ * The MIT License(MIT)
+ *
+ * Copyright(c) 2015 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+#ifndef __NYRA_CORE_VECTOR_KERNELS_H__
+#define __NYRA_CORE_VECTOR_KERNELS_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <algorithm>
+#include <array>
+#include <type_traits>
+#include <utility>
+
+/*
+ *  SIMD versions of the kernels are chosen at compile time from the
+ *  instruction sets the whole build is allowed to assume. Anything else
+ *  uses the generic loops.
+ */
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define NYRA_VECTOR_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined(__SSE4_1__) || defined(__AVX__)
+#define NYRA_VECTOR_SSE41 1
+#include <smmintrin.h>
+#endif
+
+#if defined(__AVX__)
+#define NYRA_VECTOR_AVX 1
+#include <immintrin.h>
+#endif
+
+/*
+ *  \def NYRA_HAS_CONSTANT_EVALUATED
+ *  \brief Defined when the compiler can tell constant evaluation from
+ *         runtime. Without it the kernels always use the plain loops,
+ *         since SIMD intrinsics cannot run at compile time.
+ */
+#if defined(__cpp_lib_is_constant_evaluated) || \
+    (defined(__GNUC__) && __GNUC__ >= 9) || defined(__clang__) || \
+    (defined(_MSC_VER) && _MSC_VER >= 1925)
+#define NYRA_HAS_CONSTANT_EVALUATED 1
+#endif
+
+namespace nyra
+{
+namespace core
+{
+#ifdef NYRA_HAS_CONSTANT_EVALUATED
+/*
+ *  \func isConstantEvaluated
+ *  \brief Checks if the caller is being evaluated at compile time. SIMD
+ *         intrinsics cannot be used in constant expressions so the
+ *         kernels fall back to plain loops there.
+ */
+constexpr bool isConstantEvaluated()
+{
+#if defined(__cpp_lib_is_constant_evaluated)
+    return std::is_constant_evaluated();
+#else
+    return __builtin_is_constant_evaluated();
+#endif
+}
+#endif
+
+/*
+ *  \func unroll
+ *  \brief Calls func(0) through func(SizeT - 1) as straight-line code
+ *         rather than a loop. The compiler can then keep the elements of
+ *         a small vector in registers from one operation to the next, and
+ *         vectorize a loop over many vectors as if it were a loop over
+ *         their elements.
+ */
+template <size_t SizeT, typename FuncT, size_t... IndexT>
+constexpr void unroll(const FuncT& func, std::index_sequence<IndexT...>)
+{
+    (func(IndexT), ...);
+}
+
+template <size_t SizeT, typename FuncT>
+constexpr void unroll(const FuncT& func)
+{
+    unroll<SizeT>(func, std::make_index_sequence<SizeT>());
+}
+
+/*
+ *  \class VectorLoops
+ *  \brief The element-wise operations used by Vector written without
+ *         intrinsics. Every function works on SizeT contiguous elements.
+ *         These can be evaluated at compile time.
+ *
+ *         rhs is copied before lhs is written. Otherwise the compiler has
+ *         to assume each write to lhs can change rhs, and it leaves the
+ *         operations as one element at a time.
+ */
+template <typename TypeT, size_t SizeT>
+struct VectorLoops
+{
+    static constexpr std::array<TypeT, SizeT> copy(const TypeT* values)
+    {
+        std::array<TypeT, SizeT> ret = {};
+        unroll<SizeT>([&ret, values](size_t ii)
+        {
+            ret[ii] = values[ii];
+        });
+        return ret;
+    }
+
+    static constexpr void add(TypeT* lhs, const TypeT* rhs)
+    {
+        const std::array<TypeT, SizeT> values = copy(rhs);
+        unroll<SizeT>([lhs, &values](size_t ii)
+        {
+            lhs[ii] += values[ii];
+        });
+    }
+
+    static constexpr void subtract(TypeT* lhs, const TypeT* rhs)
+    {
+        const std::array<TypeT, SizeT> values = copy(rhs);
+        unroll<SizeT>([lhs, &values](size_t ii)
+        {
+            lhs[ii] -= values[ii];
+        });
+    }
+
+    static constexpr void multiply(TypeT* lhs, const TypeT* rhs)
+    {
+        const std::array<TypeT, SizeT> values = copy(rhs);
+        unroll<SizeT>([lhs, &values](size_t ii)
+        {
+            lhs[ii] *= values[ii];
+        });
+    }
+
+    static constexpr void divide(TypeT* lhs, const TypeT* rhs)
+    {
+        const std::array<TypeT, SizeT> values = copy(rhs);
+        unroll<SizeT>([lhs, &values](size_t ii)
+        {
+            lhs[ii] /= values[ii];
+        });
+    }
+
+    static constexpr void minimum(TypeT* lhs, const TypeT* rhs)
+    {
+        const std::array<TypeT, SizeT> values = copy(rhs);
+        unroll<SizeT>([lhs, &values](size_t ii)
+        {
+            lhs[ii] = std::min(lhs[ii], values[ii]);
+        });
+    }
+
+    static constexpr void maximum(TypeT* lhs, const TypeT* rhs)
+    {
+        const std::array<TypeT, SizeT> values = copy(rhs);
+        unroll<SizeT>([lhs, &values](size_t ii)
+        {
+            lhs[ii] = std::max(lhs[ii], values[ii]);
+        });
+    }
+
+    static constexpr TypeT dot(const TypeT* lhs, const TypeT* rhs)
+    {
+        TypeT ret = static_cast<TypeT>(0);
+        for (size_t ii = 0; ii < SizeT; ++ii)
+        {
+            ret += lhs[ii] * rhs[ii];
+        }
+        return ret;
+    }
+};
+
+/*
+ *  \class VectorSimd
+ *  \brief The runtime versions of the element-wise operations. This uses
+ *         the loops by default and is specialized for sizes that map onto
+ *         SIMD registers.
+ */
+template <typename TypeT, size_t SizeT>
+struct VectorSimd : public VectorLoops<TypeT, SizeT>
+{
+};
+
+#ifdef NYRA_VECTOR_SSE2
+/*
+ *  \func horizontalSum
+ *  \brief Adds the four lanes of a register.
+ */
+inline float horizontalSum(__m128 value)
+{
+    const __m128 high = _mm_movehl_ps(value, value);
+    const __m128 pairs = _mm_add_ps(value, high);
+    const __m128 odd = _mm_shuffle_ps(pairs, pairs, _MM_SHUFFLE(1, 1, 1, 1));
+    return _mm_cvtss_f32(_mm_add_ss(pairs, odd));
+}
+
+template <>
+struct VectorSimd<float, 4>
+{
+    static void add(float* lhs, const float* rhs)
+    {
+        _mm_storeu_ps(lhs, _mm_add_ps(_mm_loadu_ps(lhs), _mm_loadu_ps(rhs)));
+    }
+
+    static void subtract(float* lhs, const float* rhs)
+    {
+        _mm_storeu_ps(lhs, _mm_sub_ps(_mm_loadu_ps(lhs), _mm_loadu_ps(rhs)));
+    }
+
+    static void multiply(float* lhs, const float* rhs)
+    {
+        _mm_storeu_ps(lhs, _mm_mul_ps(_mm_loadu_ps(lhs), _mm_loadu_ps(rhs)));
+    }
+
+    static void divide(float* lhs, const float* rhs)
+    {
+        _mm_storeu_ps(lhs, _mm_div_ps(_mm_loadu_ps(lhs), _mm_loadu_ps(rhs)));
+    }
+
+    static void minimum(float* lhs, const float* rhs)
+    {
+        // minps returns its second operand when the values are equal or
+        // either is NaN. Passing rhs first keeps lhs in those cases, the
+        // same as std::min in VectorLoops.
+        _mm_storeu_ps(lhs, _mm_min_ps(_mm_loadu_ps(rhs), _mm_loadu_ps(lhs)));
+    }
+
+    static void maximum(float* lhs, const float* rhs)
+    {
+        _mm_storeu_ps(lhs, _mm_max_ps(_mm_loadu_ps(rhs), _mm_loadu_ps(lhs)));
+    }
+
+    static float dot(const float* lhs, const float* rhs)
+    {
+        return horizontalSum(_mm_mul_ps(_mm_loadu_ps(lhs),
+                                        _mm_loadu_ps(rhs)));
+    }
+};
+
+/*
+ *  Three element vectors are loaded into the low lanes of a register. The
+ *  fourth lane is never read from or written to memory. x and y move
+ *  together as one __m64 with loadlps and storelps, and z moves on its
+ *  own with movss. __m64 may alias float, so these accesses stay ordered
+ *  with plain float stores to the same Vector.
+ *
+ *  The element-wise operations come from VectorLoops. Over an array of
+ *  vectors the compiler packs those four elements to a register across
+ *  vector boundaries, which uses all four lanes rather than three.
+ */
+template <>
+struct VectorSimd<float, 3> : public VectorLoops<float, 3>
+{
+    static __m128 load(const float* values)
+    {
+        const __m128 xy = _mm_loadl_pi(_mm_setzero_ps(),
+                                       reinterpret_cast<const __m64*>(values));
+        return _mm_movelh_ps(xy, _mm_load_ss(values + 2));
+    }
+
+    static void store(float* values, __m128 value)
+    {
+        _mm_storel_pi(reinterpret_cast<__m64*>(values), value);
+        _mm_store_ss(values + 2, _mm_movehl_ps(value, value));
+    }
+
+    static float dot(const float* lhs, const float* rhs)
+    {
+        // The unused lane is zero in both so it does not affect the sum.
+        return horizontalSum(_mm_mul_ps(load(lhs), load(rhs)));
+    }
+};
+
+template <>
+struct VectorSimd<double, 2>
+{
+    static void add(double* lhs, const double* rhs)
+    {
+        _mm_storeu_pd(lhs, _mm_add_pd(_mm_loadu_pd(lhs), _mm_loadu_pd(rhs)));
+    }
+
+    static void subtract(double* lhs, const double* rhs)
+    {
+        _mm_storeu_pd(lhs, _mm_sub_pd(_mm_loadu_pd(lhs), _mm_loadu_pd(rhs)));
+    }
+
+    static void multiply(double* lhs, const double* rhs)
+    {
+        _mm_storeu_pd(lhs, _mm_mul_pd(_mm_loadu_pd(lhs), _mm_loadu_pd(rhs)));
+    }
+
+    static void divide(double* lhs, const double* rhs)
+    {
+        _mm_storeu_pd(lhs, _mm_div_pd(_mm_loadu_pd(lhs), _mm_loadu_pd(rhs)));
+    }
+
+    static void minimum(double* lhs, const double* rhs)
+    {
+        _mm_storeu_pd(lhs, _mm_min_pd(_mm_loadu_pd(rhs), _mm_loadu_pd(lhs)));
+    }
+
+    static void maximum(double* lhs, const double* rhs)
+    {
+        _mm_storeu_pd(lhs, _mm_max_pd(_mm_loadu_pd(rhs), _mm_loadu_pd(lhs)));
+    }
+
+    static double dot(const double* lhs, const double* rhs)
+    {
+        const __m128d product = _mm_mul_pd(_mm_loadu_pd(lhs),
+                                           _mm_loadu_pd(rhs));
+        return _mm_cvtsd_f64(_mm_add_sd(product,
+                                        _mm_unpackhi_pd(product, product)));
+    }
+};
+
+/*
+ *  Integer multiply and min/max need SSE4.1. Division has no SIMD
+ *  instruction so it always uses the loop.
+ */
+template <>
+struct VectorSimd<int32_t, 4> : public VectorLoops<int32_t, 4>
+{
+    static __m128i load(const int32_t* values)
+    {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(values));
+    }
+
+    static void store(int32_t* values, __m128i value)
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(values), value);
+    }
+
+    static void add(int32_t* lhs, const int32_t* rhs)
+    {
+        store(lhs, _mm_add_epi32(load(lhs), load(rhs)));
+    }
+
+    static void subtract(int32_t* lhs, const int32_t* rhs)
+    {
+        store(lhs, _mm_sub_epi32(load(lhs), load(rhs)));
+    }
+
+#ifdef NYRA_VECTOR_SSE41
+    static void multiply(int32_t* lhs, const int32_t* rhs)
+    {
+        store(lhs, _mm_mullo_epi32(load(lhs), load(rhs)));
+    }
+
+    static void minimum(int32_t* lhs, const int32_t* rhs)
+    {
+        store(lhs, _mm_min_epi32(load(lhs), load(rhs)));
+    }
+
+    static void maximum(int32_t* lhs, const int32_t* rhs)
+    {
+        store(lhs, _mm_max_epi32(load(lhs), load(rhs)));
+    }
+
+    static int32_t dot(const int32_t* lhs, const int32_t* rhs)
+    {
+        const __m128i product = _mm_mullo_epi32(load(lhs), load(rhs));
+        const __m128i pairs = _mm_add_epi32(
+                product, _mm_shuffle_epi32(product, _MM_SHUFFLE(1, 0, 3, 2)));
+        return _mm_cvtsi128_si32(_mm_add_epi32(
+                pairs, _mm_shuffle_epi32(pairs, _MM_SHUFFLE(2, 3, 0, 1))));
+    }
+#endif
+};
+#endif
+
+#ifdef NYRA_VECTOR_AVX
+template <>
+struct VectorSimd<double, 4>
+{
+    static void add(double* lhs, const double* rhs)
+    {
+        _mm256_storeu_pd(lhs, _mm256_add_pd(_mm256_loadu_pd(lhs),
+                                            _mm256_loadu_pd(rhs)));
+    }
+
+    static void subtract(double* lhs, const double* rhs)
+    {
+        _mm256_storeu_pd(lhs, _mm256_sub_pd(_mm256_loadu_pd(lhs),
+                                            _mm256_loadu_pd(rhs)));
+    }
+
+    static void multiply(double* lhs, const double* rhs)
+    {
+        _mm256_storeu_pd(lhs, _mm256_mul_pd(_mm256_loadu_pd(lhs),
+                                            _mm256_loadu_pd(rhs)));
+    }
+
+    static void divide(double* lhs, const double* rhs)
+    {
+        _mm256_storeu_pd(lhs, _mm256_div_pd(_mm256_loadu_pd(lhs),
+                                            _mm256_loadu_pd(rhs)));
+    }
+
+    static void minimum(double* lhs, const double* rhs)
+    {
+        _mm256_storeu_pd(lhs, _mm256_min_pd(_mm256_loadu_pd(rhs),
+                                            _mm256_loadu_pd(lhs)));
+    }
+
+    static void maximum(double* lhs, const double* rhs)
+    {
+        _mm256_storeu_pd(lhs, _mm256_max_pd(_mm256_loadu_pd(rhs),
+                                            _mm256_loadu_pd(lhs)));
+    }
+
+    static double dot(const double* lhs, const double* rhs)
+    {
+        const __m256d product = _mm256_mul_pd(_mm256_loadu_pd(lhs),
+                                              _mm256_loadu_pd(rhs));
+        const __m128d sum = _mm_add_pd(_mm256_castpd256_pd128(product),
+                                       _mm256_extractf128_pd(product, 1));
+        return _mm_cvtsd_f64(_mm_add_sd(sum, _mm_unpackhi_pd(sum, sum)));
+    }
+};
+#endif
+#ifdef NYRA_HAS_CONSTANT_EVALUATED
+/*
+ *  \class VectorKernels
+ *  \brief The element-wise operations used by Vector. This uses the SIMD
+ *         versions at runtime and the plain loops at compile time.
+ */
+template <typename TypeT, size_t SizeT>
+struct VectorKernels
+{
+    static constexpr void add(TypeT* lhs, const TypeT* rhs)
+    {
+        if (isConstantEvaluated())
+        {
+            VectorLoops<TypeT, SizeT>::add(lhs, rhs);
+        }
+        else
+        {
+            VectorSimd<TypeT, SizeT>::add(lhs, rhs);
+        }
+    }
+
+    static constexpr void subtract(TypeT* lhs, const TypeT* rhs)
+    {
+        if (isConstantEvaluated())
+        {
+            VectorLoops<TypeT, SizeT>::subtract(lhs, rhs);
+        }
+        else
+        {
+            VectorSimd<TypeT, SizeT>::subtract(lhs, rhs);
+        }
+    }
+
+    static constexpr void multiply(TypeT* lhs, const TypeT* rhs)
+    {
+        if (isConstantEvaluated())
+        {
+            VectorLoops<TypeT, SizeT>::multiply(lhs, rhs);
+        }
+        else
+        {
+            VectorSimd<TypeT, SizeT>::multiply(lhs, rhs);
+        }
+    }
+
+    static constexpr void divide(TypeT* lhs, const TypeT* rhs)
+    {
+        if (isConstantEvaluated())
+        {
+            VectorLoops<TypeT, SizeT>::divide(lhs, rhs);
+        }
+        else
+        {
+            VectorSimd<TypeT, SizeT>::divide(lhs, rhs);
+        }
+    }
+
+    static constexpr void minimum(TypeT* lhs, const TypeT* rhs)
+    {
+        if (isConstantEvaluated())
+        {
+            VectorLoops<TypeT, SizeT>::minimum(lhs, rhs);
+        }
+        else
+        {
+            VectorSimd<TypeT, SizeT>::minimum(lhs, rhs);
+        }
+    }
+
+    static constexpr void maximum(TypeT* lhs, const TypeT* rhs)
+    {
+        if (isConstantEvaluated())
+        {
+            VectorLoops<TypeT, SizeT>::maximum(lhs, rhs);
+        }
+        else
+        {
+            VectorSimd<TypeT, SizeT>::maximum(lhs, rhs);
+        }
+    }
+
+    static constexpr TypeT dot(const TypeT* lhs, const TypeT* rhs)
+    {
+        if (isConstantEvaluated())
+        {
+            return VectorLoops<TypeT, SizeT>::dot(lhs, rhs);
+        }
+        return VectorSimd<TypeT, SizeT>::dot(lhs, rhs);
+    }
+};
+#else
+/*
+ *  \class VectorKernels
+ *  \brief The element-wise operations used by Vector. The compiler cannot
+ *         tell compile time from runtime, so the plain loops are used
+ *         everywhere to keep Vector constexpr.
+ */
+template <typename TypeT, size_t SizeT>
+struct VectorKernels : public VectorLoops<TypeT, SizeT>
+{
+};
+#endif
+}
+}
+
+#endif
@@ -0,0 +1,105 @@
+/******************************************************************************
+ * The MIT License(MIT)
+ *
+ * Copyright(c) 2015 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+#ifndef __NYRA_GRAPHICS_DIRTY_REGION_H__
+#define __NYRA_GRAPHICS_DIRTY_REGION_H__
+
+#include <vector>
+#include <graphics/Rect.h>
+
+namespace nyra
+{
+namespace graphics
+{
+/*
+ *  \class DirtyRegion
+ *  \brief Tracks the parts of a frame that changed so only those parts
+ *         need to be copied to the screen. Rectangles that overlap or
+ *         touch are merged as they are added. If there are still too many
+ *         the two that waste the least area when combined are merged, so
+ *         the list stays short enough to hand to the display each frame.
+ */
+class DirtyRegion
+{
+public:
+    /*
+     *  \func Constructor
+     *  \brief Creates an empty region.
+     *
+     *  \param maxRects The most rectangles to keep before merging.
+     */
+    explicit DirtyRegion(size_t maxRects = 16);
+
+    /*
+     *  \func add
+     *  \brief Marks a rectangle as changed. Empty rectangles are ignored.
+     */
+    void add(const Rect& rect);
+
+    /*
+     *  \func clip
+     *  \brief Removes everything outside of bounds.
+     */
+    void clip(const Rect& bounds);
+
+    void clear()
+    {
+        mRects.clear();
+    }
+
+    bool isEmpty() const
+    {
+        return mRects.empty();
+    }
+
+    /*
+     *  \func getRects
+     *  \brief Gets the changed rectangles. They do not overlap or touch.
+     */
+    const std::vector<Rect>& getRects() const
+    {
+        return mRects;
+    }
+
+    /*
+     *  \func getBounds
+     *  \brief Gets the smallest rectangle that holds every change.
+     */
+    Rect getBounds() const;
+
+    /*
+     *  \func getArea
+     *  \brief Gets the number of pixels that changed.
+     */
+    int64_t getArea() const;
+
+private:
+    void mergeCheapestPair();
+
+    size_t mMaxRects;
+    std::vector<Rect> mRects;
+};
+}
+}
+
+#endif
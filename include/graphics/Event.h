@@ -0,0 +1,117 @@
+/******************************************************************************
+ * The MIT License(MIT)
+ *
+ * Copyright(c) 2015 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+#ifndef __NYRA_GRAPHICS_EVENT_H__
+#define __NYRA_GRAPHICS_EVENT_H__
+
+#include <stdint.h>
+
+namespace nyra
+{
+namespace graphics
+{
+/*
+ *  \struct Event
+ *  \brief An input or window event. Only the member of the union that
+ *         matches type is set.
+ *
+ *         timestamp is taken from the steady clock, in nanoseconds, when
+ *         the event is queued. Comparing it to the same clock when the
+ *         event is handled gives the time it spent waiting in the queue.
+ *         sourceTime is the time the platform recorded, in its own units,
+ *         or 0 if it has none.
+ */
+struct Event
+{
+    enum Type
+    {
+        QUIT,
+        KEY_DOWN,
+        KEY_UP,
+        MOUSE_MOTION,
+        MOUSE_BUTTON_DOWN,
+        MOUSE_BUTTON_UP,
+        MOUSE_WHEEL,
+        RESIZED,
+        FOCUS_GAINED,
+        FOCUS_LOST
+    };
+
+    struct Key
+    {
+        int32_t code;
+        uint16_t modifiers;
+        bool repeat;
+    };
+
+    struct MouseMotion
+    {
+        int32_t x;
+        int32_t y;
+        int32_t deltaX;
+        int32_t deltaY;
+    };
+
+    struct MouseButton
+    {
+        int32_t x;
+        int32_t y;
+        uint8_t button;
+        uint8_t clicks;
+    };
+
+    struct MouseWheel
+    {
+        int32_t x;
+        int32_t y;
+    };
+
+    struct Resize
+    {
+        int32_t width;
+        int32_t height;
+    };
+
+    Type type;
+    uint64_t timestamp;
+    uint32_t sourceTime;
+    union
+    {
+        Key key;
+        MouseMotion motion;
+        MouseButton button;
+        MouseWheel wheel;
+        Resize resize;
+    };
+};
+
+/*
+ *  \func getEventTime
+ *  \brief Gets the steady clock in nanoseconds, the same clock used for
+ *         Event::timestamp.
+ */
+uint64_t getEventTime();
+}
+}
+
+#endif
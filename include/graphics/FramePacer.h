@@ -0,0 +1,106 @@
+/******************************************************************************
+ * The MIT License(MIT)
+ *
+ * Copyright(c) 2015 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+#ifndef __NYRA_GRAPHICS_FRAME_PACER_H__
+#define __NYRA_GRAPHICS_FRAME_PACER_H__
+
+#include <stddef.h>
+#include <chrono>
+
+namespace nyra
+{
+namespace graphics
+{
+/*
+ *  \class FramePacer
+ *  \brief Holds a loop to a fixed frame rate. Sleeping alone wakes up too
+ *         late by up to the scheduler's granularity, so the pacer sleeps
+ *         until shortly before each deadline and spins for the rest.
+ *         Deadlines are a fixed period apart rather than a period after
+ *         each wait, so small delays do not add up over time.
+ */
+class FramePacer
+{
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    /*
+     *  \func Constructor
+     *
+     *  \param rate The target number of frames per second. 0 means wait
+     *         never blocks.
+     */
+    explicit FramePacer(double rate = 0.0);
+
+    /*
+     *  \func setRate
+     *  \brief Changes the target frames per second and restarts pacing
+     *         from the next wait. 0 turns pacing off.
+     */
+    void setRate(double rate);
+
+    double getRate() const
+    {
+        return mRate;
+    }
+
+    /*
+     *  \func setSpinTime
+     *  \brief Sets how long before each deadline to stop sleeping and
+     *         spin instead. Longer is more accurate but burns more CPU.
+     *         The default is 2 milliseconds.
+     */
+    void setSpinTime(double seconds);
+
+    /*
+     *  \func wait
+     *  \brief Blocks until the end of the current frame. If the frame ran
+     *         past its deadline this returns at once. If it ran past by a
+     *         whole period or more, the schedule restarts from now instead
+     *         of rushing to catch up.
+     *
+     *  \return The number of deadlines that passed before wait was
+     *          called, which is 0 for a frame that finished on time.
+     */
+    size_t wait();
+
+    /*
+     *  \func reset
+     *  \brief Starts a new schedule at the next wait.
+     */
+    void reset()
+    {
+        mStarted = false;
+    }
+
+private:
+    double mRate;
+    Clock::duration mPeriod;
+    Clock::duration mSpinTime;
+    Clock::time_point mDeadline;
+    bool mStarted;
+};
+}
+}
+
+#endif
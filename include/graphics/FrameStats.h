@@ -0,0 +1,157 @@
+/******************************************************************************
+ * The MIT License(MIT)
+ *
+ * Copyright(c) 2015 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+#ifndef __NYRA_GRAPHICS_FRAME_STATS_H__
+#define __NYRA_GRAPHICS_FRAME_STATS_H__
+
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+namespace nyra
+{
+namespace graphics
+{
+/*
+ *  \class FrameStats
+ *  \brief Keeps the time spent in each stage of the last few hundred
+ *         frames so stutter can be tracked down to the part of the frame
+ *         that caused it.
+ *
+ *         Stage times can be added from any thread, for example by a
+ *         presentation thread, and are summed until endFrame moves them
+ *         into the history. Everything else must be called from the
+ *         thread that ends frames.
+ */
+class FrameStats
+{
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    /*
+     *  \enum Stage
+     *
+     *  \value EVENTS - Moving platform events into the event queue.
+     *  \value COPY - Copying or converting pixels for the screen.
+     *  \value PRESENT - Handing the copied pixels to the display.
+     *  \value WAIT - Waiting for the frame pacer.
+     *  \value FRAME - The whole frame, from the end of the last one.
+     */
+    enum Stage
+    {
+        EVENTS,
+        COPY,
+        PRESENT,
+        WAIT,
+        FRAME,
+        NUM_STAGES
+    };
+
+    /*
+     *  \func Constructor
+     *
+     *  \param historySize The number of frames to keep.
+     */
+    explicit FrameStats(size_t historySize = 512);
+
+    /*
+     *  \func addStageTime
+     *  \brief Adds the time from start until now to a stage of the
+     *         current frame.
+     *
+     *  \return The current time, so the next stage can start from it.
+     */
+    Clock::time_point addStageTime(Stage stage, Clock::time_point start);
+
+    /*
+     *  \func endFrame
+     *  \brief Moves the current stage times into the history.
+     *
+     *  \param frameTime The length of the whole frame in seconds.
+     *  \param dropped The number of frames that were skipped because this
+     *         one ran late.
+     */
+    void endFrame(double frameTime, size_t dropped);
+
+    /*
+     *  \func getPercentile
+     *  \brief Gets the time, in seconds, that the given percent of the
+     *         frames in the history spent in a stage or less. 50 is the
+     *         median and 100 is the slowest frame.
+     */
+    double getPercentile(Stage stage, double percent) const;
+
+    /*
+     *  \func getAverage
+     *  \brief Gets the mean time in seconds spent in a stage over the
+     *         history.
+     */
+    double getAverage(Stage stage) const;
+
+    /*
+     *  \func getLast
+     *  \brief Gets the time in seconds spent in a stage by the last frame.
+     */
+    double getLast(Stage stage) const;
+
+    /*
+     *  \func getNumFrames
+     *  \brief Gets the number of frames ended since the last reset. This
+     *         can be more than the history holds.
+     */
+    size_t getNumFrames() const
+    {
+        return mNumFrames;
+    }
+
+    /*
+     *  \func getNumDropped
+     *  \brief Gets the number of frames dropped since the last reset.
+     */
+    size_t getNumDropped() const
+    {
+        return mNumDropped;
+    }
+
+    /*
+     *  \func reset
+     *  \brief Clears the history and counts.
+     */
+    void reset();
+
+private:
+    size_t getHistoryCount() const;
+
+    const size_t mHistorySize;
+    std::vector<double> mHistory[NUM_STAGES];
+    std::atomic<int64_t> mCurrent[NUM_STAGES];
+    size_t mNext;
+    size_t mNumFrames;
+    size_t mNumDropped;
+    mutable std::vector<double> mScratch;
+};
+}
+}
+
+#endif
@@ -0,0 +1,82 @@
+/******************************************************************************
+ * The MIT License(MIT)
+ *
+ * Copyright(c) 2015 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+#ifndef __NYRA_GRAPHICS_IMAGE_H__
+#define __NYRA_GRAPHICS_IMAGE_H__
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <graphics/PixelFormat.h>
+
+namespace nyra
+{
+namespace graphics
+{
+/*
+ *  \struct Image
+ *  \brief An image that owns its tightly packed pixels.
+ */
+struct Image
+{
+    Image() :
+        size(0, 0),
+        format(RGBA8)
+    {
+    }
+
+    Image(const core::Vector2UI& dimensions, PixelFormat layout) :
+        size(dimensions),
+        format(layout),
+        pixels(dimensions.x() * dimensions.y() * getBytesPerPixel(layout))
+    {
+    }
+
+    PixelBuffer getBuffer() const
+    {
+        return PixelBuffer(pixels.empty() ? nullptr : &pixels[0],
+                           size,
+                           format);
+    }
+
+    core::Vector2UI size;
+    PixelFormat format;
+    std::vector<uint8_t> pixels;
+};
+
+/*
+ *  \func readTGA
+ *  \brief Reads a Truevision TGA image. Raw and run length encoded color
+ *         images with 24 or 32 bits per pixel become BGRA8, with 24 bit
+ *         images made opaque. 8 bit grayscale images become GRAY8. Rows
+ *         are always returned top first.
+ *
+ *  \param pathname The pathname to the file on disk. This can be
+ *         relative or absolute.
+ *  \throw If the file cannot be read or uses another kind of TGA.
+ */
+Image readTGA(const std::string& pathname);
+}
+}
+
+#endif
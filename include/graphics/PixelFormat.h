@@ -0,0 +1,141 @@
+/******************************************************************************
+ * The MIT License(MIT)
+ *
+ * Copyright(c) 2015 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+#ifndef __NYRA_GRAPHICS_PIXEL_FORMAT_H__
+#define __NYRA_GRAPHICS_PIXEL_FORMAT_H__
+
+#include <stddef.h>
+#include <vector>
+#include <core/Vector.h>
+#include <graphics/Rect.h>
+
+namespace nyra
+{
+namespace graphics
+{
+/*
+ *  \enum PixelFormat
+ *  \brief The layout of a pixel in memory.
+ *
+ *  RGBA8 - Four bytes in the order red, green, blue, alpha.
+ *  BGRA8 - Four bytes in the order blue, green, red, alpha.
+ *  RGB565 - A native endian 16 bit value with red in the top 5 bits,
+ *           green in the middle 6 bits and blue in the bottom 5 bits.
+ *  GRAY8 - One byte of brightness.
+ */
+enum PixelFormat
+{
+    RGBA8,
+    BGRA8,
+    RGB565,
+    GRAY8
+};
+
+/*
+ *  \func getBytesPerPixel
+ *  \brief Gets the size of one pixel in a format.
+ */
+size_t getBytesPerPixel(PixelFormat format);
+
+/*
+ *  \class PixelBuffer
+ *  \brief Describes an image in memory without owning it.
+ */
+struct PixelBuffer
+{
+    /*
+     *  \func Constructor
+     *  \brief Describes an image.
+     *
+     *  \param data The first row of the image.
+     *  \param dimensions The width and height in pixels.
+     *  \param layout The layout of each pixel.
+     *  \param rowPitch The number of bytes from the start of one row to the
+     *                  start of the next. 0 means the rows are tightly
+     *                  packed.
+     */
+    PixelBuffer(const void* data,
+                const core::Vector2UI& dimensions,
+                PixelFormat layout,
+                size_t rowPitch = 0) :
+        pixels(data),
+        size(dimensions),
+        format(layout),
+        pitch(rowPitch ? rowPitch :
+                         dimensions.x() * getBytesPerPixel(layout))
+    {
+    }
+
+    const void* pixels;
+    core::Vector2UI size;
+    PixelFormat format;
+    size_t pitch;
+};
+
+/*
+ *  \func convertPixels
+ *  \brief Converts an image from one format to another a row at a time.
+ *         Common conversions use SIMD kernels. Converting to a format
+ *         without alpha drops it, converting from one sets it to opaque.
+ *         Conversions to GRAY8 use the Rec. 601 luma weights.
+ *
+ *  \param source The image to convert.
+ *  \param destination [OUTPUT] The first row of the converted image. This
+ *                     must not overlap the source.
+ *  \param destinationPitch The number of bytes from the start of one row
+ *                          of the destination to the start of the next.
+ *  \param destinationFormat The format to convert to.
+ */
+void convertPixels(const PixelBuffer& source,
+                   void* destination,
+                   size_t destinationPitch,
+                   PixelFormat destinationFormat);
+
+/*
+ *  \func convertRects
+ *  \brief Converts only some rectangles of an image, such as the parts of
+ *         a frame that changed. Both images use the same coordinates and
+ *         each rectangle is clipped to the smaller of the two.
+ *
+ *  \param source The image to convert.
+ *  \param rects The parts of the image to convert.
+ *  \param destination [OUTPUT] The first row of the converted image. This
+ *                     must not overlap the source.
+ *  \param destinationSize The width and height of the destination.
+ *  \param destinationPitch The number of bytes from the start of one row
+ *                          of the destination to the start of the next.
+ *  \param destinationFormat The format to convert to.
+ *  \param converted [OUTPUT] Optional. The clipped rectangles that were
+ *                   converted are appended to this.
+ */
+void convertRects(const PixelBuffer& source,
+                  const std::vector<Rect>& rects,
+                  void* destination,
+                  const core::Vector2UI& destinationSize,
+                  size_t destinationPitch,
+                  PixelFormat destinationFormat,
+                  std::vector<Rect>* converted = nullptr);
+}
+}
+
+#endif
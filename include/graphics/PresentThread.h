@@ -0,0 +1,187 @@
+/******************************************************************************
+ * The MIT License(MIT)
+ *
+ * Copyright(c) 2015 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+#ifndef __NYRA_GRAPHICS_PRESENT_THREAD_H__
+#define __NYRA_GRAPHICS_PRESENT_THREAD_H__
+
+#include <stdint.h>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <core/AlignedAllocator.h>
+#include <graphics/Window.h>
+
+namespace nyra
+{
+namespace graphics
+{
+/*
+ *  \class PresentThread
+ *  \brief Presents frames to a window from a dedicated thread so the
+ *         thread drawing them never waits for the copy to the screen.
+ *
+ *         There are three frames. The caller draws into the back buffer
+ *         and submits it, the presentation thread shows the front buffer,
+ *         and the third holds the newest submitted frame between the two.
+ *         Submitting swaps the back buffer with that middle one using a
+ *         single atomic exchange. If the previous submitted frame was
+ *         never shown it is dropped, so the screen always gets the latest
+ *         frame.
+ *
+ *         The window's showBuffer is called from the presentation thread,
+ *         so the window must allow presenting from a thread other than
+ *         the one that created it. Events should still be handled on the
+ *         caller's thread.
+ */
+class PresentThread
+{
+public:
+    /*
+     *  \func Constructor
+     *  \brief Allocates the frames and starts the presentation thread.
+     *
+     *  \param window The window to present to. It must outlive this.
+     *  \param size The size of each frame in pixels.
+     *  \param format The pixel format the caller draws in.
+     */
+    PresentThread(Window& window,
+                  const core::Vector2UI& size,
+                  PixelFormat format);
+
+    /*
+     *  \func Destructor
+     *  \brief Stops the presentation thread. A frame that was submitted
+     *         but not shown yet is discarded.
+     */
+    ~PresentThread();
+
+    PresentThread(const PresentThread&) = delete;
+    PresentThread& operator=(const PresentThread&) = delete;
+
+    /*
+     *  \func getBackBuffer
+     *  \brief Gets the frame to draw into. This changes after each call to
+     *         submit, and the new frame holds whatever an older frame left
+     *         in it, so it must be redrawn or cleared.
+     */
+    void* getBackBuffer()
+    {
+        return &mBuffers[mBack][0];
+    }
+
+    /*
+     *  \func submit
+     *  \brief Hands the back buffer to the presentation thread and takes
+     *         another frame to draw into. This does not wait for the
+     *         frame to be shown.
+     *
+     *  \throw The exception thrown by the window if presenting an earlier
+     *         frame failed. No more frames are shown after that.
+     */
+    void submit();
+
+    const core::Vector2UI& getSize() const
+    {
+        return mSize;
+    }
+
+    PixelFormat getFormat() const
+    {
+        return mFormat;
+    }
+
+    /*
+     *  \func getPitch
+     *  \brief Gets the number of bytes between the start of each row.
+     */
+    size_t getPitch() const
+    {
+        return mPitch;
+    }
+
+    /*
+     *  \func getNumPresented
+     *  \brief Gets the number of frames shown so far.
+     */
+    size_t getNumPresented() const
+    {
+        return mNumPresented.load(std::memory_order_relaxed);
+    }
+
+    /*
+     *  \func getNumDropped
+     *  \brief Gets the number of submitted frames that were replaced by a
+     *         newer frame before they could be shown.
+     */
+    size_t getNumDropped() const
+    {
+        return mNumDropped.load(std::memory_order_relaxed);
+    }
+
+private:
+    typedef std::vector<uint8_t, core::AlignedAllocator<uint8_t> > Buffer;
+
+    bool waitForFrame();
+
+    void run();
+
+    static const uint32_t NUM_BUFFERS = 3;
+    static const uint32_t INDEX_MASK = 3;
+    static const uint32_t FRESH = 4;
+
+    Window& mWindow;
+    const core::Vector2UI mSize;
+    const PixelFormat mFormat;
+    const size_t mPitch;
+    Buffer mBuffers[NUM_BUFFERS];
+
+    // The back buffer is only touched by the caller and the front buffer
+    // only by the presentation thread. mReady holds the index of the
+    // frame between them, with FRESH set if it has not been shown yet.
+    uint32_t mBack;
+    uint32_t mFront;
+    std::atomic<uint32_t> mReady;
+
+    std::atomic<size_t> mNumPresented;
+    std::atomic<size_t> mNumDropped;
+
+    // Only used to put the presentation thread to sleep while there is
+    // nothing to show. submit only takes the lock if the thread is
+    // already asleep.
+    std::mutex mMutex;
+    std::condition_variable mCondition;
+    std::atomic<bool> mWaiting;
+    bool mStop;
+
+    std::atomic<bool> mFailed;
+    std::exception_ptr mError;
+
+    std::thread mThread;
+};
+}
+}
+
+#endif
@@ -0,0 +1,283 @@
+/******************************************************************************
+ * The MIT License(MIT)
+ *
+ * Copyright(c) 2015 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+#ifndef __NYRA_GRAPHICS_RASTERIZER_H__
+#define __NYRA_GRAPHICS_RASTERIZER_H__
+
+#include <stdint.h>
+#include <vector>
+#include <core/Vector.h>
+#include <core/ThreadPool.h>
+#include <graphics/PixelFormat.h>
+#include <graphics/Rect.h>
+#include <graphics/TextureAtlas.h>
+
+namespace nyra
+{
+namespace graphics
+{
+/*
+ *  \struct Color
+ *  \brief A color with straight, not premultiplied, alpha.
+ */
+struct Color
+{
+    Color() :
+        red(0),
+        green(0),
+        blue(0),
+        alpha(255)
+    {
+    }
+
+    Color(uint8_t r, uint8_t g, uint8_t b, uint8_t a = 255) :
+        red(r),
+        green(g),
+        blue(b),
+        alpha(a)
+    {
+    }
+
+    uint8_t red;
+    uint8_t green;
+    uint8_t blue;
+    uint8_t alpha;
+};
+
+/*
+ *  \class Rasterizer
+ *  \brief Draws 2D shapes and images into an RGBA8 or BGRA8 image on the
+ *         CPU. Draw calls are only recorded until flush, which splits the
+ *         image into tiles and draws each tile on its own. Tiles can run
+ *         on different threads because no two share a pixel, and each
+ *         tile runs its commands in the order they were recorded.
+ *
+ *         Anything with alpha below 255 is blended over what is already
+ *         drawn. Pixel (x, y) covers the area from (x, y) to
+ *         (x + 1, y + 1), so its center is at (x + 0.5, y + 0.5).
+ */
+class Rasterizer
+{
+public:
+    /*
+     *  \func Constructor
+     *  \brief Sets the image to draw into.
+     *
+     *  \param pixels The first row of the image.
+     *  \param size The width and height in pixels.
+     *  \param format RGBA8 or BGRA8.
+     *  \param pitch The bytes from one row to the next. 0 means the rows
+     *         are tightly packed.
+     *  \throw If the format is not 32 bits per pixel.
+     */
+    Rasterizer(void* pixels,
+               const core::Vector2UI& size,
+               PixelFormat format,
+               size_t pitch = 0);
+
+    /*
+     *  \func getTarget
+     *  \brief Gets the image being drawn into, for passing to
+     *         Window::showBuffer after a flush.
+     */
+    PixelBuffer getTarget() const
+    {
+        return PixelBuffer(mPixels, mSize, mFormat, mPitch);
+    }
+
+    /*
+     *  \func clear
+     *  \brief Sets every pixel to a color without blending. Commands
+     *         recorded before this are discarded since they would be
+     *         covered anyway.
+     */
+    void clear(const Color& color);
+
+    /*
+     *  \func fillRect
+     *  \brief Fills a rectangle.
+     */
+    void fillRect(const Rect& rect, const Color& color);
+
+    /*
+     *  \func drawRect
+     *  \brief Draws the one pixel wide outline just inside a rectangle.
+     */
+    void drawRect(const Rect& rect, const Color& color);
+
+    /*
+     *  \func drawLine
+     *  \brief Draws a one pixel wide line between the pixels holding the
+     *         two points, including both ends.
+     */
+    void drawLine(const core::Vector2F& start,
+                  const core::Vector2F& end,
+                  const Color& color);
+
+    /*
+     *  \func fillTriangle
+     *  \brief Fills the pixels whose centers are inside a triangle.
+     *         Pixels exactly on an edge shared by two triangles are only
+     *         drawn by one of them.
+     */
+    void fillTriangle(const core::Vector2F& first,
+                      const core::Vector2F& second,
+                      const core::Vector2F& third,
+                      const Color& color);
+
+    /*
+     *  \func fillTriangle
+     *  \brief Fills a triangle, interpolating the color given for each
+     *         corner across it.
+     */
+    void fillTriangle(const core::Vector2F& first,
+                      const core::Vector2F& second,
+                      const core::Vector2F& third,
+                      const Color& firstColor,
+                      const Color& secondColor,
+                      const Color& thirdColor);
+
+    /*
+     *  \func blit
+     *  \brief Blends a whole image over the target.
+     *
+     *  \param image An RGBA8 or BGRA8 image. It is not copied, so it must
+     *         stay valid until flush.
+     *  \param position Where the top left corner of the image goes.
+     *  \throw If the image is not 32 bits per pixel.
+     */
+    void blit(const PixelBuffer& image, const core::Vector2I& position);
+
+    /*
+     *  \func blit
+     *  \brief Blends part of an image, such as one sprite from a sheet,
+     *         over the target.
+     *
+     *  \param image An RGBA8 or BGRA8 image. It is not copied, so it must
+     *         stay valid until flush.
+     *  \param source The part of the image to draw.
+     *  \param position Where the top left corner of source goes.
+     *  \throw If the image is not 32 bits per pixel.
+     */
+    void blit(const PixelBuffer& image,
+              const Rect& source,
+              const core::Vector2I& position);
+
+    /*
+     *  \func blit
+     *  \brief Blends an image from a texture atlas over the target,
+     *         reading its tiled page directly.
+     *
+     *  \param atlas The atlas holding the image. It is not copied, so it
+     *         must stay valid and unchanged until flush.
+     *  \param handle The image returned by TextureAtlas::add.
+     *  \param position Where the top left corner of the image goes.
+     */
+    void blit(const TextureAtlas& atlas,
+              TextureAtlas::Handle handle,
+              const core::Vector2I& position);
+
+    /*
+     *  \func flush
+     *  \brief Draws every recorded command and forgets them.
+     *
+     *  \param pool Optional workers to draw tiles in parallel.
+     */
+    void flush(core::ThreadPool* pool = nullptr);
+
+    size_t getNumCommands() const
+    {
+        return mCommands.size();
+    }
+
+private:
+    enum CommandType
+    {
+        CLEAR,
+        FILL,
+        LINE,
+        TRIANGLE,
+        BLIT,
+        ATLAS_BLIT
+    };
+
+    struct Command
+    {
+        CommandType type;
+
+        // The part of the target the command can change.
+        Rect bounds;
+
+        // Colors are stored in the byte order of the target.
+        uint8_t colors[3][4];
+
+        // Line end points or triangle corners. Lines use whole pixels.
+        core::Vector2F points[3];
+
+        // Blits store where pixel (0, 0) of the source lands.
+        const uint8_t* image;
+        size_t imagePitch;
+        bool swapRedBlue;
+        core::Vector2I origin;
+
+        // Atlas blits read from a page rather than a linear image.
+        const TextureAtlas* atlas;
+        size_t page;
+    };
+
+    void toTarget(const Color& color, uint8_t* bytes) const;
+
+    void push(const Command& command);
+
+    void drawTile(const Rect& tile, const std::vector<uint32_t>& bin);
+
+    void drawLine(const Command& command, const Rect& area);
+
+    void drawTriangle(const Command& command, const Rect& area);
+
+    void drawBlit(const Command& command, const Rect& area);
+
+    void drawAtlasBlit(const Command& command, const Rect& area);
+
+    uint8_t* getPixel(int32_t x, int32_t y) const
+    {
+        return mPixels + y * mPitch + x * 4;
+    }
+
+    static const int32_t TILE_WIDTH = 1024;
+    static const int32_t TILE_HEIGHT = 32;
+
+    uint8_t* mPixels;
+    core::Vector2UI mSize;
+    PixelFormat mFormat;
+    size_t mPitch;
+    Rect mBounds;
+    int32_t mTileColumns;
+    int32_t mTileRows;
+    std::vector<Command> mCommands;
+    std::vector<std::vector<uint32_t> > mBins;
+};
+}
+}
+
+#endif
@@ -0,0 +1,160 @@
+/******************************************************************************
+ * The MIT License(MIT)
+ *
+ * Copyright(c) 2015 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+#ifndef __NYRA_GRAPHICS_RECT_H__
+#define __NYRA_GRAPHICS_RECT_H__
+
+#include <stdint.h>
+#include <algorithm>
+
+namespace nyra
+{
+namespace graphics
+{
+/*
+ *  \class Rect
+ *  \brief A rectangle of pixels. The left and top edges are inside the
+ *         rectangle, the right and bottom edges (x + width, y + height)
+ *         are not. A rectangle with no width or height is empty.
+ */
+struct Rect
+{
+    Rect() :
+        x(0),
+        y(0),
+        width(0),
+        height(0)
+    {
+    }
+
+    Rect(int32_t left, int32_t top, int32_t w, int32_t h) :
+        x(left),
+        y(top),
+        width(w),
+        height(h)
+    {
+    }
+
+    int32_t getRight() const
+    {
+        return x + width;
+    }
+
+    int32_t getBottom() const
+    {
+        return y + height;
+    }
+
+    bool isEmpty() const
+    {
+        return width <= 0 || height <= 0;
+    }
+
+    int64_t getArea() const
+    {
+        return isEmpty() ? 0 : static_cast<int64_t>(width) * height;
+    }
+
+    bool operator==(const Rect& rhs) const
+    {
+        return x == rhs.x && y == rhs.y &&
+               width == rhs.width && height == rhs.height;
+    }
+
+    bool operator!=(const Rect& rhs) const
+    {
+        return !operator==(rhs);
+    }
+
+    /*
+     *  \func contains
+     *  \brief Checks if another rectangle is entirely inside this one.
+     */
+    bool contains(const Rect& other) const
+    {
+        return other.x >= x && other.y >= y &&
+               other.getRight() <= getRight() &&
+               other.getBottom() <= getBottom();
+    }
+
+    /*
+     *  \func touches
+     *  \brief Checks if two rectangles overlap or share an edge.
+     */
+    bool touches(const Rect& other) const
+    {
+        return other.x <= getRight() && other.getRight() >= x &&
+               other.y <= getBottom() && other.getBottom() >= y;
+    }
+
+    /*
+     *  \func intersect
+     *  \brief Gets the overlap of two rectangles. This is empty if they do
+     *         not overlap.
+     */
+    Rect intersect(const Rect& other) const
+    {
+        const int32_t left = std::max(x, other.x);
+        const int32_t top = std::max(y, other.y);
+        const int32_t right = std::min(getRight(), other.getRight());
+        const int32_t bottom = std::min(getBottom(), other.getBottom());
+        if (right <= left || bottom <= top)
+        {
+            return Rect();
+        }
+        return Rect(left, top, right - left, bottom - top);
+    }
+
+    /*
+     *  \func unite
+     *  \brief Gets the smallest rectangle that holds both rectangles.
+     *         Empty rectangles are ignored.
+     */
+    Rect unite(const Rect& other) const
+    {
+        if (isEmpty())
+        {
+            return other;
+        }
+        if (other.isEmpty())
+        {
+            return *this;
+        }
+
+        const int32_t left = std::min(x, other.x);
+        const int32_t top = std::min(y, other.y);
+        return Rect(left,
+                    top,
+                    std::max(getRight(), other.getRight()) - left,
+                    std::max(getBottom(), other.getBottom()) - top);
+    }
+
+    int32_t x;
+    int32_t y;
+    int32_t width;
+    int32_t height;
+};
+}
+}
+
+#endif
@@ -0,0 +1,208 @@
+/******************************************************************************
+ * The MIT License(MIT)
+ *
+ * Copyright(c) 2015 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+#ifndef __NYRA_GRAPHICS_TEXTURE_ATLAS_H__
+#define __NYRA_GRAPHICS_TEXTURE_ATLAS_H__
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <core/AlignedAllocator.h>
+#include <graphics/PixelFormat.h>
+#include <graphics/Rect.h>
+
+namespace nyra
+{
+namespace graphics
+{
+/*
+ *  \class TextureAtlas
+ *  \brief Packs many small images into a few large pages so drawing them
+ *         reads from a handful of allocations instead of one per image.
+ *
+ *         Images are placed with a skyline packer, which keeps the top
+ *         edge of the used space of each page and puts each new image
+ *         where it leaves that edge lowest. Pages are stored in
+ *         TILE_SIZE by TILE_SIZE tiles, each tile's pixels kept together,
+ *         so the rows of a small image sit close to each other in memory
+ *         rather than a whole page width apart. Images no wider than a
+ *         tile never cross a tile's left or right edge, so each of their
+ *         rows is contiguous.
+ */
+class TextureAtlas
+{
+public:
+    typedef uint32_t Handle;
+
+    /*
+     *  \struct Region
+     *  \brief Where an image was placed. The texture coordinates run
+     *         from 0 to 1 across the page.
+     */
+    struct Region
+    {
+        size_t page;
+        Rect rect;
+        float left;
+        float top;
+        float right;
+        float bottom;
+    };
+
+    static const size_t TILE_SIZE = 64;
+
+    // Every image starts on a multiple of this many pixels.
+    static const int32_t ALIGNMENT = 4;
+
+    /*
+     *  \func Constructor
+     *  \brief Creates an empty atlas. Pages are only allocated when
+     *         needed.
+     *
+     *  \param pageSize The size of each page. This is rounded up to whole
+     *         tiles.
+     *  \param format RGBA8 or BGRA8.
+     *  \throw If the format is not 32 bits per pixel.
+     */
+    explicit TextureAtlas(
+            const core::Vector2UI& pageSize = core::Vector2UI(1024, 1024),
+            PixelFormat format = BGRA8);
+
+    /*
+     *  \func add
+     *  \brief Copies an image into the atlas, converting it to the atlas
+     *         format.
+     *
+     *  \return A handle to look up where the image went.
+     *  \throw If the image is bigger than a page.
+     */
+    Handle add(const PixelBuffer& image);
+
+    /*
+     *  \func add
+     *  \brief Reads a TGA image from disk and copies it into the atlas.
+     *
+     *  \throw If the file cannot be read or is bigger than a page.
+     */
+    Handle add(const std::string& pathname);
+
+    const Region& getRegion(Handle handle) const
+    {
+        return mRegions[handle];
+    }
+
+    size_t getNumRegions() const
+    {
+        return mRegions.size();
+    }
+
+    size_t getNumPages() const
+    {
+        return mPages.size();
+    }
+
+    const core::Vector2UI& getPageSize() const
+    {
+        return mPageSize;
+    }
+
+    PixelFormat getFormat() const
+    {
+        return mFormat;
+    }
+
+    /*
+     *  \func getPixel
+     *  \brief Gets a pixel of a page. The pixels to its right up to the
+     *         next multiple of TILE_SIZE follow it in memory.
+     */
+    const uint8_t* getPixel(size_t page, size_t x, size_t y) const
+    {
+        return &mPages[page].pixels[getOffset(x, y)];
+    }
+
+    /*
+     *  \func copyRegion
+     *  \brief Copies an image back out of the atlas into ordinary rows.
+     *
+     *  \param handle The image to copy.
+     *  \param destination Where to write the first row.
+     *  \param pitch The bytes from one row of the destination to the next.
+     *         0 means the rows are tightly packed.
+     */
+    void copyRegion(Handle handle, void* destination, size_t pitch = 0) const;
+
+private:
+    // A horizontal piece of the skyline. Everything below y is used.
+    struct Segment
+    {
+        int32_t x;
+        int32_t y;
+        int32_t width;
+    };
+
+#ifdef __linux__
+    // Pages start on a huge page boundary so the kernel can map each one
+    // with a few huge pages rather than a thousand small ones.
+    static const size_t PIXEL_ALIGNMENT = 2 * 1024 * 1024;
+#else
+    static const size_t PIXEL_ALIGNMENT = 64;
+#endif
+
+    struct Page
+    {
+        std::vector<uint8_t, core::AlignedAllocator<uint8_t, PIXEL_ALIGNMENT> >
+                pixels;
+        std::vector<Segment> skyline;
+    };
+
+    size_t getOffset(size_t x, size_t y) const
+    {
+        const size_t tile = (y / TILE_SIZE) * mTileColumns + x / TILE_SIZE;
+        return (tile * TILE_SIZE * TILE_SIZE +
+                (y % TILE_SIZE) * TILE_SIZE +
+                x % TILE_SIZE) * 4;
+    }
+
+    bool findPosition(const Page& page,
+                      int32_t width,
+                      int32_t height,
+                      int32_t& x,
+                      int32_t& y) const;
+
+    static void addSegment(Page& page,
+                           int32_t x,
+                           int32_t width,
+                           int32_t height,
+                           int32_t y);
+
+    core::Vector2UI mPageSize;
+    PixelFormat mFormat;
+    size_t mTileColumns;
+    std::vector<Page> mPages;
+    std::vector<Region> mRegions;
+};
+}
+}
+
+#endif
@@ -25,7 +25,14 @@
 #define __NYRA_GRAPHICS_WINDOW_H__
 
 #include <string>
+#include <atomic>
 #include <core/Vector.h>
+#include <core/RingBuffer.h>
+#include <graphics/PixelFormat.h>
+#include <graphics/DirtyRegion.h>
+#include <graphics/Event.h>
+#include <graphics/FramePacer.h>
+#include <graphics/FrameStats.h>
 
 namespace nyra
 {
@@ -34,6 +41,15 @@ namespace graphics
 class Window
 {
 public:
+    /*
+     *  \func Constructor
+     *  \brief Sets up the event queue.
+     *
+     *  \param eventCapacity The most events that can wait to be polled.
+     *         Events that arrive while the queue is full are dropped.
+     */
+    explicit Window(size_t eventCapacity = 1024);
+
     virtual ~Window();
 
     inline void setSize(size_t width, size_t height)
@@ -54,9 +70,146 @@ public:
 
     virtual core::Vector2I getPosition() const = 0;
 
+    /*
+     *  \func update
+     *  \brief Moves pending platform events into the event queue.
+     *
+     *  \return False once the window has been asked to close.
+     */
     virtual bool update() = 0;
 
+    /*
+     *  \func pollEvents
+     *  \brief Removes events from the front of the queue without waiting
+     *         or locking. This may be called from any one thread, which
+     *         does not have to be the thread calling update.
+     *
+     *  \param events Where to copy the events.
+     *  \param count The most events to remove.
+     *  \return The number of events removed.
+     */
+    size_t pollEvents(Event* events, size_t count)
+    {
+        return mEvents.pop(events, count);
+    }
+
+    bool pollEvent(Event& event)
+    {
+        return mEvents.pop(event);
+    }
+
+    /*
+     *  \func postEvent
+     *  \brief Adds an event to the queue. This is safe to call from any
+     *         thread, for example to inject input. If the timestamp is 0
+     *         it is set to the current time.
+     *
+     *  \return False if the queue is full and the event was dropped.
+     */
+    bool postEvent(const Event& event);
+
+    /*
+     *  \func getNumDroppedEvents
+     *  \brief Gets the number of events lost because the queue was full.
+     */
+    size_t getNumDroppedEvents() const
+    {
+        return mNumDroppedEvents.load(std::memory_order_relaxed);
+    }
+
+    /*
+     *  \func showBuffer
+     *  \brief Copies pixels that already match the window's own pixel
+     *         format and width to the screen.
+     */
     virtual void showBuffer(const void* buffer, size_t size) = 0;
+
+    /*
+     *  \func showBuffer
+     *  \brief Converts an image to the window's pixel format while copying
+     *         it to the screen. Anything past the window's size is clipped.
+     */
+    virtual void showBuffer(const PixelBuffer& buffer) = 0;
+
+    /*
+     *  \func showBuffer
+     *  \brief Like the full image version but only copies the parts of
+     *         the image inside region. Nothing else on the screen changes.
+     */
+    virtual void showBuffer(const PixelBuffer& buffer,
+                            const DirtyRegion& region) = 0;
+
+    /*
+     *  \func markDirty
+     *  \brief Records that part of the image changed since the last call
+     *         to showDirty. Nearby rectangles are merged as they are added.
+     */
+    void markDirty(const Rect& rect)
+    {
+        mDirty.add(rect);
+    }
+
+    /*
+     *  \func markAllDirty
+     *  \brief Records that the whole window needs to be redrawn.
+     */
+    void markAllDirty();
+
+    const DirtyRegion& getDirtyRegion() const
+    {
+        return mDirty;
+    }
+
+    /*
+     *  \func showDirty
+     *  \brief Copies the parts of an image marked as dirty to the screen
+     *         and then clears the dirty region. This does nothing if no
+     *         part of the image was marked.
+     */
+    void showDirty(const PixelBuffer& buffer);
+
+    /*
+     *  \func finishFrame
+     *  \brief Ends the current frame. This waits for the frame pacer and
+     *         then records the frame in the frame statistics. Call it once
+     *         per frame after presenting.
+     *
+     *  \return The number of frames dropped because this one ran late.
+     */
+    size_t finishFrame();
+
+    /*
+     *  \func getFramePacer
+     *  \brief Gets the pacer used by finishFrame. It does not wait until
+     *         a rate is set.
+     */
+    FramePacer& getFramePacer()
+    {
+        return mPacer;
+    }
+
+    /*
+     *  \func getFrameStats
+     *  \brief Gets the time spent pumping events, copying, presenting and
+     *         waiting for each recent frame.
+     */
+    FrameStats& getFrameStats()
+    {
+        return mFrameStats;
+    }
+
+    const FrameStats& getFrameStats() const
+    {
+        return mFrameStats;
+    }
+
+private:
+    DirtyRegion mDirty;
+    core::MpscRingBuffer<Event> mEvents;
+    std::atomic<size_t> mNumDroppedEvents;
+    FramePacer mPacer;
+    FrameStats mFrameStats;
+    FrameStats::Clock::time_point mFrameStart;
 };
 }
 }
@@ -0,0 +1,170 @@
+/******************************************************************************
+ * The MIT License(MIT)
+ *
+ * Copyright(c) 2015 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+#ifndef __NYRA_GRAPHICS_WINDOW_HEADLESS_H__
+#define __NYRA_GRAPHICS_WINDOW_HEADLESS_H__
+
+#include <stdint.h>
+#include <vector>
+#include <chrono>
+#include <graphics/Window.h>
+
+namespace nyra
+{
+namespace graphics
+{
+/*
+ *  \class WindowHeadless
+ *  \brief A window that only exists in memory. Presenting copies into an
+ *         owned framebuffer without waiting for a display, so the frame
+ *         pipeline runs as fast as it can. This allows it to be timed and
+ *         checked on machines with no display at all.
+ */
+class WindowHeadless : public Window
+{
+public:
+    /*
+     *  \struct Timings
+     *  \brief The time spent presenting frames, in seconds. Writing frames
+     *         to disk is not included.
+     */
+    struct Timings
+    {
+        Timings();
+
+        double getAverage() const
+        {
+            return count ? total / count : 0.0;
+        }
+
+        size_t count;
+        double total;
+        double minimum;
+        double maximum;
+        double last;
+    };
+
+    /*
+     *  \func Constructor
+     *  \brief Creates a cleared framebuffer.
+     *
+     *  \param size The size of the framebuffer in pixels.
+     *  \param position Where the window claims to be. This is only
+     *         stored.
+     *  \param format The pixel format of the framebuffer.
+     */
+    WindowHeadless(const core::Vector2UI& size,
+                   const core::Vector2I& position = core::Vector2I(0, 0),
+                   PixelFormat format = BGRA8);
+
+    /*
+     *  \func setSize
+     *  \brief Resizes and clears the framebuffer.
+     */
+    virtual void setSize(const core::Vector2UI& size);
+
+    virtual void setPosition(const core::Vector2I& position);
+
+    virtual core::Vector2UI getSize() const;
+
+    virtual core::Vector2I getPosition() const;
+
+    /*
+     *  \func update
+     *  \brief Returns false once close has been called.
+     */
+    virtual bool update();
+
+    virtual void showBuffer(const void* buffer, size_t size);
+
+    virtual void showBuffer(const PixelBuffer& buffer);
+
+    virtual void showBuffer(const PixelBuffer& buffer,
+                            const DirtyRegion& region);
+
+    /*
+     *  \func close
+     *  \brief Queues a QUIT event and makes the next call to update return
+     *         false, the same as a user closing a real window.
+     */
+    void close();
+
+    /*
+     *  \func getFramebuffer
+     *  \brief Gets the pixels as they would appear on the screen.
+     */
+    PixelBuffer getFramebuffer() const
+    {
+        return PixelBuffer(mPixels.empty() ? nullptr : &mPixels[0],
+                           mSize,
+                           mFormat,
+                           mPitch);
+    }
+
+    const Timings& getTimings() const
+    {
+        return mTimings;
+    }
+
+    void resetTimings()
+    {
+        mTimings = Timings();
+    }
+
+    /*
+     *  \func setDumpDirectory
+     *  \brief Writes every frame presented from now on to the directory
+     *         as frame_000000.ppm, frame_000001.ppm and so on. The
+     *         directory must already exist. Pass an empty string to stop.
+     */
+    void setDumpDirectory(const std::string& directory)
+    {
+        mDumpDirectory = directory;
+    }
+
+    /*
+     *  \func saveFrame
+     *  \brief Writes the framebuffer to disk as a binary PPM image.
+     *
+     *  \param pathname The pathname of the image to write.
+     *  \throw If the file cannot be written.
+     */
+    void saveFrame(const std::string& pathname) const;
+
+private:
+    void finishPresent(std::chrono::steady_clock::time_point start);
+
+    core::Vector2UI mSize;
+    core::Vector2I mPosition;
+    const PixelFormat mFormat;
+    size_t mPitch;
+    std::vector<uint8_t> mPixels;
+    bool mOpen;
+    Timings mTimings;
+    std::string mDumpDirectory;
+    size_t mNumDumped;
+};
+}
+}
+
+#endif
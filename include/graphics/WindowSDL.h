@@ -24,6 +24,7 @@
 #ifndef __NYRA_GRAPHICS_WINDOW_SDL_H__
 #define __NYRA_GRAPHICS_WINDOW_SDL_H__
 
+#include <vector>
 #include <SDL.h>
 #include <graphics/Window.h>
 
@@ -52,9 +53,26 @@ public:
 
     virtual void showBuffer(const void* buffer, size_t size);
 
+    virtual void showBuffer(const PixelBuffer& buffer);
+
+    virtual void showBuffer(const PixelBuffer& buffer,
+                            const DirtyRegion& region);
+
 private:
+    static PixelFormat getPixelFormat(Uint32 format);
+
+    static void lockSurface(SDL_Surface* surface);
+
+    static void unlockSurface(SDL_Surface* surface);
+
+    static bool translateEvent(const SDL_Event& source, Event& event);
+
+    static const int EVENT_BATCH_SIZE = 64;
+
     SDL_Window* mWindow;
-    SDL_Event mEvent;
+    SDL_Event mBatch[EVENT_BATCH_SIZE];
+    std::vector<Rect> mConvertedRects;
+    std::vector<SDL_Rect> mUpdateRects;
 };
 }
 }
@@ -23,9 +23,21 @@
  *****************************************************************************/
 #include <sstream>
 #include <fstream>
+#include <algorithm>
 #include <core/File.h>
 #include <core/Exception.h>
 
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 namespace nyra
 {
 namespace core
@@ -58,9 +70,14 @@ std::string readFile(const std::string& pathname)
 /*****************************************************************************/
 std::vector<uint8_t> readBinary(const std::string& pathname)
 {
-    // TODO: Is it better to just use the existing stream here even
-    //       thought we would rewrite some code?
-    const size_t bufferSize = getFileSize(pathname);
+    // Open the file in binary mode at the end so the size is known
+    // without opening the file a second time.
+    std::ifstream stream(pathname, std::ios::ate | std::ios::binary);
+    if (!stream.good())
+    {
+        throw Exception("Failed to open file: " + pathname);
+    }
+    const size_t bufferSize = static_cast<size_t>(stream.tellg());
 
     // Return an empty vector if there is nothing to read.
     if (bufferSize == 0)
@@ -68,19 +85,286 @@ std::vector<uint8_t> readBinary(const std::string& pathname)
         return std::vector<uint8_t>();
     }
 
-    // Open the file in binary mode.
-    std::ifstream stream(pathname, std::ios::binary);
-    if (!stream.good())
+    std::vector<uint8_t> ret(bufferSize);
+    stream.seekg(0, std::ios::beg);
+    stream.read(reinterpret_cast<char*>(&ret[0]), bufferSize);
+
+    return ret;
+}
+
+/*****************************************************************************/
+size_t getPageSize()
+{
+#ifdef _WIN32
+    static const size_t pageSize = []()
+    {
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        return static_cast<size_t>(info.dwPageSize);
+    }();
+#else
+    static const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+    return pageSize;
+}
+
+/*****************************************************************************/
+MappedFile::MappedFile() :
+    mData(nullptr),
+    mSize(0)
+{
+}
+
+/*****************************************************************************/
+MappedFile::MappedFile(const std::string& pathname, Advice advice) :
+    mData(nullptr),
+    mSize(0)
+{
+    open(pathname, advice);
+}
+
+/*****************************************************************************/
+MappedFile::MappedFile(MappedFile&& other) :
+    mData(other.mData),
+    mSize(other.mSize)
+{
+    other.mData = nullptr;
+    other.mSize = 0;
+}
+
+/*****************************************************************************/
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+/*****************************************************************************/
+MappedFile& MappedFile::operator=(MappedFile&& other)
+{
+    if (this != &other)
+    {
+        close();
+        mData = other.mData;
+        mSize = other.mSize;
+        other.mData = nullptr;
+        other.mSize = 0;
+    }
+    return *this;
+}
+
+#ifdef _WIN32
+/*****************************************************************************/
+void MappedFile::open(const std::string& pathname, Advice advice)
+{
+    close();
+
+    DWORD flags = FILE_ATTRIBUTE_NORMAL;
+    if (advice == SEQUENTIAL)
+    {
+        flags |= FILE_FLAG_SEQUENTIAL_SCAN;
+    }
+    else if (advice == RANDOM)
+    {
+        flags |= FILE_FLAG_RANDOM_ACCESS;
+    }
+
+    HANDLE file = CreateFileA(pathname.c_str(),
+                              GENERIC_READ,
+                              FILE_SHARE_READ,
+                              nullptr,
+                              OPEN_EXISTING,
+                              flags,
+                              nullptr);
+    if (file == INVALID_HANDLE_VALUE)
     {
         throw Exception("Failed to open file: " + pathname);
     }
 
-    // Go to the end of the stream to figure out how large it is.
-    std::vector<uint8_t> ret(bufferSize);
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize))
+    {
+        CloseHandle(file);
+        throw Exception("Failed to get size of file: " + pathname);
+    }
 
-    stream.read(reinterpret_cast<char*>(&ret[0]), bufferSize);
+    // Windows cannot map an empty file.
+    if (fileSize.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return;
+    }
 
-    return ret;
+    if (static_cast<uint64_t>(fileSize.QuadPart) >
+            static_cast<uint64_t>(static_cast<size_t>(-1)))
+    {
+        CloseHandle(file);
+        throw Exception("File is too large to map: " + pathname);
+    }
+
+    HANDLE mapping = CreateFileMappingA(file,
+                                        nullptr,
+                                        PAGE_READONLY,
+                                        0,
+                                        0,
+                                        nullptr);
+
+    // The view keeps its own reference to the file so the handles can be
+    // closed as soon as it exists.
+    CloseHandle(file);
+    if (!mapping)
+    {
+        throw Exception("Failed to map file: " + pathname);
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (!view)
+    {
+        throw Exception("Failed to map file: " + pathname);
+    }
+
+    mData = static_cast<const uint8_t*>(view);
+    mSize = static_cast<size_t>(fileSize.QuadPart);
+
+    if (advice == WILL_NEED)
+    {
+        this->advise(advice);
+    }
+}
+
+/*****************************************************************************/
+void MappedFile::close()
+{
+    if (mData)
+    {
+        UnmapViewOfFile(mData);
+    }
+    mData = nullptr;
+    mSize = 0;
+}
+
+/*****************************************************************************/
+void MappedFile::advise(Advice advice, size_t offset, size_t size)
+{
+    if (!mData || offset >= mSize)
+    {
+        return;
+    }
+
+    // Windows only supports prefetching once a view exists. Sequential and
+    // random hints are applied to the file handle when it is opened.
+#if _WIN32_WINNT >= 0x0602
+    if (advice == WILL_NEED)
+    {
+        WIN32_MEMORY_RANGE_ENTRY range;
+        range.VirtualAddress = const_cast<uint8_t*>(mData + offset);
+        range.NumberOfBytes = std::min(size, mSize - offset);
+        PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+    }
+#else
+    (void)advice;
+    (void)size;
+#endif
+}
+#else
+/*****************************************************************************/
+void MappedFile::open(const std::string& pathname, Advice advice)
+{
+    close();
+
+    const int descriptor = ::open(pathname.c_str(), O_RDONLY);
+    if (descriptor < 0)
+    {
+        throw Exception("Failed to open file: " + pathname);
+    }
+
+    struct stat info;
+    if (fstat(descriptor, &info) != 0)
+    {
+        ::close(descriptor);
+        throw Exception("Failed to get size of file: " + pathname);
+    }
+
+    // mmap cannot map an empty file.
+    if (info.st_size == 0)
+    {
+        ::close(descriptor);
+        return;
+    }
+
+    void* view = mmap(nullptr,
+                      static_cast<size_t>(info.st_size),
+                      PROT_READ,
+                      MAP_PRIVATE,
+                      descriptor,
+                      0);
+
+    // The mapping keeps its own reference to the file.
+    ::close(descriptor);
+    if (view == MAP_FAILED)
+    {
+        throw Exception("Failed to map file: " + pathname);
+    }
+
+    mData = static_cast<const uint8_t*>(view);
+    mSize = static_cast<size_t>(info.st_size);
+
+    if (advice != NORMAL)
+    {
+        this->advise(advice);
+    }
+}
+
+/*****************************************************************************/
+void MappedFile::close()
+{
+    if (mData)
+    {
+        munmap(const_cast<uint8_t*>(mData), mSize);
+    }
+    mData = nullptr;
+    mSize = 0;
+}
+
+/*****************************************************************************/
+void MappedFile::advise(Advice advice, size_t offset, size_t size)
+{
+    if (!mData || offset >= mSize)
+    {
+        return;
+    }
+
+    // madvise requires a page aligned address.
+    const size_t pageSize = getPageSize();
+    const size_t alignedOffset = offset - (offset % pageSize);
+    const size_t length = std::min(size, mSize - offset) +
+            (offset - alignedOffset);
+
+    int flag = MADV_NORMAL;
+    switch (advice)
+    {
+    case SEQUENTIAL:
+        flag = MADV_SEQUENTIAL;
+        break;
+    case RANDOM:
+        flag = MADV_RANDOM;
+        break;
+    case WILL_NEED:
+        flag = MADV_WILLNEED;
+        break;
+    default:
+        break;
+    }
+
+    // Advice is only a hint so failures are not fatal.
+    madvise(const_cast<uint8_t*>(mData + alignedOffset), length, flag);
+}
+#endif
+
+/*****************************************************************************/
+void MappedFile::advise(Advice advice)
+{
+    advise(advice, 0, mSize);
 }
 }
 }
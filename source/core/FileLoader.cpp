@@ -0,0 +1,87 @@
+/******************************************************************************
+ * The MIT License(MIT)
+ *
+ * Copyright(c) 2015 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+#include <core/FileLoader.h>
+#include <core/File.h>
+#include <core/Exception.h>
+
+namespace nyra
+{
+namespace core
+{
+/*****************************************************************************/
+FileLoader::FileLoader(size_t numThreads) :
+    mPool(numThreads)
+{
+}
+
+/*****************************************************************************/
+std::future<FileLoader::Buffer> FileLoader::load(const std::string& pathname)
+{
+    return mPool.submit([pathname]()
+    {
+        return readBinary(pathname);
+    });
+}
+
+/*****************************************************************************/
+std::vector<std::future<FileLoader::Buffer> > FileLoader::load(
+        const std::vector<std::string>& pathnames)
+{
+    std::vector<std::future<Buffer> > ret;
+    ret.reserve(pathnames.size());
+    for (size_t ii = 0; ii < pathnames.size(); ++ii)
+    {
+        ret.push_back(load(pathnames[ii]));
+    }
+    return ret;
+}
+
+/*****************************************************************************/
+void FileLoader::prefetch(const std::string& pathname)
+{
+    mPool.submit([pathname]()
+    {
+        try
+        {
+            // Touch one byte per page so every page is faulted in on this
+            // thread rather than the one that later reads the file.
+            const MappedFile file(pathname, MappedFile::SEQUENTIAL);
+            const size_t pageSize = getPageSize();
+            uint8_t touched = 0;
+            for (size_t ii = 0; ii < file.size(); ii += pageSize)
+            {
+                touched ^= file.data()[ii];
+            }
+
+            // Keep the reads from being optimized away.
+            volatile uint8_t sink = touched;
+            (void)sink;
+        }
+        catch (const Exception&)
+        {
+        }
+    });
+}
+}
+}
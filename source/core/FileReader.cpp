@@ -0,0 +1,156 @@
+/******************************************************************************
+ * The MIT License(MIT)
+ *
+ * Copyright(c) 2015 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+#include <core/FileReader.h>
+#include <core/Exception.h>
+
+namespace nyra
+{
+namespace core
+{
+/*****************************************************************************/
+FileReader::FileReader() :
+    mSize(0)
+{
+}
+
+/*****************************************************************************/
+FileReader::FileReader(const std::string& pathname) :
+    mSize(0)
+{
+    open(pathname);
+}
+
+/*****************************************************************************/
+void FileReader::open(const std::string& pathname)
+{
+    close();
+
+    mStream.open(pathname, std::ios::ate | std::ios::binary);
+    if (!mStream.good())
+    {
+        mStream.close();
+        throw Exception("Failed to open file: " + pathname);
+    }
+
+    mPathname = pathname;
+    mSize = static_cast<uint64_t>(mStream.tellg());
+    mStream.seekg(0, std::ios::beg);
+}
+
+/*****************************************************************************/
+void FileReader::close()
+{
+    if (mStream.is_open())
+    {
+        mStream.close();
+    }
+    mStream.clear();
+    mPathname.clear();
+    mSize = 0;
+}
+
+/*****************************************************************************/
+size_t FileReader::read(void* buffer, size_t size)
+{
+    checkOpen();
+    if (size == 0 || mStream.eof())
+    {
+        return 0;
+    }
+
+    mStream.read(static_cast<char*>(buffer),
+                 static_cast<std::streamsize>(size));
+    const size_t bytesRead = static_cast<size_t>(mStream.gcount());
+
+    // A short read sets fail as well as eof. Clear fail so tell keeps
+    // working but remember that the end was reached.
+    if (mStream.eof())
+    {
+        mStream.clear(std::ios::eofbit);
+    }
+    else if (mStream.fail())
+    {
+        throw Exception("Failed to read file: " + mPathname);
+    }
+    return bytesRead;
+}
+
+/*****************************************************************************/
+bool FileReader::readLine(std::string& line)
+{
+    checkOpen();
+    line.clear();
+    if (mStream.eof() || mStream.peek() == std::char_traits<char>::eof())
+    {
+        mStream.clear(std::ios::eofbit);
+        return false;
+    }
+
+    std::getline(mStream, line);
+    if (!line.empty() && line.back() == '\r')
+    {
+        line.pop_back();
+    }
+
+    if (mStream.eof())
+    {
+        mStream.clear(std::ios::eofbit);
+    }
+    return true;
+}
+
+/*****************************************************************************/
+void FileReader::seek(uint64_t offset)
+{
+    checkOpen();
+    if (offset > mSize)
+    {
+        throw Exception("Cannot seek past the end of file: " + mPathname);
+    }
+
+    mStream.clear();
+    mStream.seekg(static_cast<std::streamoff>(offset), std::ios::beg);
+}
+
+/*****************************************************************************/
+uint64_t FileReader::tell()
+{
+    checkOpen();
+    if (mStream.eof())
+    {
+        return mSize;
+    }
+    return static_cast<uint64_t>(mStream.tellg());
+}
+
+/*****************************************************************************/
+void FileReader::checkOpen() const
+{
+    if (!mStream.is_open())
+    {
+        throw Exception("No file is open for reading.");
+    }
+}
+}
+}
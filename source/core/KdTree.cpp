@@ -0,0 +1,408 @@
+/******************************************************************************
+ * The MIT License(MIT)
+ *
+ * Copyright(c) 2015 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+#include <algorithm>
+#include <limits>
+#include <core/KdTree.h>
+#include <core/Exception.h>
+
+namespace
+{
+// Deep enough for any tree that fits in 32 bit ids.
+const size_t MAX_STACK = 64;
+
+// Subtrees smaller than this are not split up for other threads.
+const size_t MIN_PARALLEL_POINTS = 4096;
+
+struct Range
+{
+    size_t node;
+    size_t begin;
+    size_t end;
+};
+
+float distanceSquared(const nyra::core::Vector2F& lhs,
+                      const nyra::core::Vector2F& rhs)
+{
+    const float x = lhs.x() - rhs.x();
+    const float y = lhs.y() - rhs.y();
+    return x * x + y * y;
+}
+}
+
+namespace nyra
+{
+namespace core
+{
+/*****************************************************************************/
+KdTree::KdTree()
+{
+}
+
+/*****************************************************************************/
+size_t KdTree::countNodes(size_t index, size_t count)
+{
+    // The right child never has fewer points than the left so the deepest,
+    // rightmost node is always reached by going right.
+    while (count > LEAF_SIZE)
+    {
+        index = index * 2 + 2;
+        count -= count / 2;
+    }
+    return index + 1;
+}
+
+/*****************************************************************************/
+void KdTree::build(const Vector2F* positions, size_t count, ThreadPool* pool)
+{
+    if (count > std::numeric_limits<Id>::max())
+    {
+        throw Exception("Too many points for a KdTree.");
+    }
+
+    mItems.resize(count);
+    mSlots.resize(count);
+    mNodes.clear();
+    if (count == 0)
+    {
+        return;
+    }
+
+    for (size_t ii = 0; ii < count; ++ii)
+    {
+        mItems[ii].position = positions[ii];
+        mItems[ii].id = static_cast<Id>(ii);
+    }
+    mNodes.resize(countNodes(0, count));
+
+    // Split the top of the tree on this thread until there are enough
+    // separate subtrees to keep every worker busy.
+    std::vector<Range> ranges(1, Range{0, 0, count});
+    if (pool)
+    {
+        const size_t target = (pool->getNumThreads() + 1) * 4;
+        bool split = true;
+        while (split && ranges.size() < target)
+        {
+            split = false;
+            std::vector<Range> next;
+            for (size_t ii = 0; ii < ranges.size(); ++ii)
+            {
+                const Range& range = ranges[ii];
+                if (range.end - range.begin < MIN_PARALLEL_POINTS)
+                {
+                    next.push_back(range);
+                    continue;
+                }
+
+                splitNode(range.node, range.begin, range.end);
+                const size_t middle = range.begin +
+                                      (range.end - range.begin) / 2;
+                next.push_back(Range{range.node * 2 + 1, range.begin, middle});
+                next.push_back(Range{range.node * 2 + 2, middle, range.end});
+                split = true;
+            }
+            ranges.swap(next);
+        }
+
+        pool->parallelFor(ranges.size(), 1, [&](size_t begin, size_t end)
+        {
+            for (size_t ii = begin; ii < end; ++ii)
+            {
+                buildNode(ranges[ii].node, ranges[ii].begin, ranges[ii].end);
+            }
+        });
+    }
+    else
+    {
+        buildNode(0, 0, count);
+    }
+
+    for (size_t ii = 0; ii < count; ++ii)
+    {
+        mSlots[mItems[ii].id] = static_cast<uint32_t>(ii);
+    }
+}
+
+/*****************************************************************************/
+void KdTree::splitNode(size_t index, size_t begin, size_t end)
+{
+    Node& node = mNodes[index];
+    node.begin = static_cast<uint32_t>(begin);
+    node.end = static_cast<uint32_t>(end);
+    node.bounds = Bounds2F();
+    for (size_t ii = begin; ii < end; ++ii)
+    {
+        node.bounds.expand(mItems[ii].position);
+    }
+
+    if (isLeaf(node))
+    {
+        return;
+    }
+
+    const Vector2F size = node.bounds.maximum - node.bounds.minimum;
+    const size_t axis = size.x() >= size.y() ? 0 : 1;
+    std::nth_element(mItems.begin() + begin,
+                     mItems.begin() + begin + (end - begin) / 2,
+                     mItems.begin() + end,
+                     [axis](const Item& lhs, const Item& rhs)
+    {
+        return lhs.position.data()[axis] < rhs.position.data()[axis];
+    });
+}
+
+/*****************************************************************************/
+void KdTree::buildNode(size_t index, size_t begin, size_t end)
+{
+    splitNode(index, begin, end);
+    if (!isLeaf(mNodes[index]))
+    {
+        const size_t middle = begin + (end - begin) / 2;
+        buildNode(index * 2 + 1, begin, middle);
+        buildNode(index * 2 + 2, middle, end);
+    }
+}
+
+/*****************************************************************************/
+void KdTree::setPosition(Id id, const Vector2F& position)
+{
+    if (id >= mSlots.size())
+    {
+        throw Exception("Invalid point id.");
+    }
+    mItems[mSlots[id]].position = position;
+}
+
+/*****************************************************************************/
+const Vector2F& KdTree::getPosition(Id id) const
+{
+    if (id >= mSlots.size())
+    {
+        throw Exception("Invalid point id.");
+    }
+    return mItems[mSlots[id]].position;
+}
+
+/*****************************************************************************/
+void KdTree::refitLeaf(Node& node)
+{
+    node.bounds = Bounds2F();
+    for (size_t ii = node.begin; ii < node.end; ++ii)
+    {
+        node.bounds.expand(mItems[ii].position);
+    }
+}
+
+/*****************************************************************************/
+void KdTree::refit(ThreadPool* pool)
+{
+    // Unused slots in the implicit layout have no points.
+    auto refitLeaves = [this](size_t begin, size_t end)
+    {
+        for (size_t ii = begin; ii < end; ++ii)
+        {
+            Node& node = mNodes[ii];
+            if (node.end > node.begin && isLeaf(node))
+            {
+                refitLeaf(node);
+            }
+        }
+    };
+
+    if (pool)
+    {
+        pool->parallelFor(mNodes.size(), 4096, refitLeaves);
+    }
+    else
+    {
+        refitLeaves(0, mNodes.size());
+    }
+
+    // Children always come after their parent.
+    for (size_t ii = mNodes.size(); ii-- > 0;)
+    {
+        Node& node = mNodes[ii];
+        if (node.end > node.begin && !isLeaf(node))
+        {
+            node.bounds = mNodes[ii * 2 + 1].bounds;
+            node.bounds.expand(mNodes[ii * 2 + 2].bounds);
+        }
+    }
+}
+
+/*****************************************************************************/
+void KdTree::queryRadius(const Vector2F& center,
+                         float radius,
+                         std::vector<Id>& out) const
+{
+    if (mNodes.empty() || radius < 0.0f)
+    {
+        return;
+    }
+
+    const float radiusSquared = radius * radius;
+    size_t stack[MAX_STACK];
+    size_t stackSize = 0;
+    stack[stackSize++] = 0;
+    while (stackSize)
+    {
+        const size_t index = stack[--stackSize];
+        const Node& node = mNodes[index];
+        if (node.bounds.distanceSquared(center) > radiusSquared)
+        {
+            continue;
+        }
+
+        if (isLeaf(node))
+        {
+            for (size_t ii = node.begin; ii < node.end; ++ii)
+            {
+                if (distanceSquared(mItems[ii].position, center) <=
+                        radiusSquared)
+                {
+                    out.push_back(mItems[ii].id);
+                }
+            }
+        }
+        else
+        {
+            stack[stackSize++] = index * 2 + 1;
+            stack[stackSize++] = index * 2 + 2;
+        }
+    }
+}
+
+/*****************************************************************************/
+void KdTree::queryBounds(const Bounds2F& bounds, std::vector<Id>& out) const
+{
+    if (mNodes.empty())
+    {
+        return;
+    }
+
+    size_t stack[MAX_STACK];
+    size_t stackSize = 0;
+    stack[stackSize++] = 0;
+    while (stackSize)
+    {
+        const size_t index = stack[--stackSize];
+        const Node& node = mNodes[index];
+        if (!bounds.intersects(node.bounds))
+        {
+            continue;
+        }
+
+        if (bounds.contains(node.bounds))
+        {
+            for (size_t ii = node.begin; ii < node.end; ++ii)
+            {
+                out.push_back(mItems[ii].id);
+            }
+        }
+        else if (isLeaf(node))
+        {
+            for (size_t ii = node.begin; ii < node.end; ++ii)
+            {
+                if (bounds.contains(mItems[ii].position))
+                {
+                    out.push_back(mItems[ii].id);
+                }
+            }
+        }
+        else
+        {
+            stack[stackSize++] = index * 2 + 1;
+            stack[stackSize++] = index * 2 + 2;
+        }
+    }
+}
+
+/*****************************************************************************/
+void KdTree::queryNearest(const Vector2F& center,
+                          size_t count,
+                          std::vector<Id>& out) const
+{
+    count = std::min(count, mItems.size());
+    if (count == 0)
+    {
+        return;
+    }
+
+    std::vector<std::pair<float, Id> > heap;
+    heap.reserve(count + 1);
+    size_t stack[MAX_STACK];
+    size_t stackSize = 0;
+    stack[stackSize++] = 0;
+    while (stackSize)
+    {
+        const size_t index = stack[--stackSize];
+        const Node& node = mNodes[index];
+        if (heap.size() == count &&
+            node.bounds.distanceSquared(center) >= heap.front().first)
+        {
+            continue;
+        }
+
+        if (isLeaf(node))
+        {
+            for (size_t ii = node.begin; ii < node.end; ++ii)
+            {
+                const float distance =
+                        distanceSquared(mItems[ii].position, center);
+                if (heap.size() < count)
+                {
+                    heap.push_back(std::make_pair(distance, mItems[ii].id));
+                    std::push_heap(heap.begin(), heap.end());
+                }
+                else if (distance < heap.front().first)
+                {
+                    std::pop_heap(heap.begin(), heap.end());
+                    heap.back() = std::make_pair(distance, mItems[ii].id);
+                    std::push_heap(heap.begin(), heap.end());
+                }
+            }
+            continue;
+        }
+
+        // Visit the closer child first so the heap fills with good
+        // candidates early and more of the far child can be skipped.
+        size_t nearChild = index * 2 + 1;
+        size_t farChild = index * 2 + 2;
+        if (mNodes[farChild].bounds.distanceSquared(center) <
+            mNodes[nearChild].bounds.distanceSquared(center))
+        {
+            std::swap(nearChild, farChild);
+        }
+        stack[stackSize++] = farChild;
+        stack[stackSize++] = nearChild;
+    }
+
+    std::sort_heap(heap.begin(), heap.end());
+    for (size_t ii = 0; ii < heap.size(); ++ii)
+    {
+        out.push_back(heap[ii].second);
+    }
+}
+}
+}
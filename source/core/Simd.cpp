@@ -0,0 +1,131 @@
+/******************************************************************************
+ * The MIT License(MIT)
+ *
+ * Copyright(c) 2015 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+#include <stddef.h>
+#include <core/Simd.h>
+
+#if defined(NYRA_X86) && !defined(_MSC_VER)
+#include <cpuid.h>
+#endif
+
+namespace
+{
+/*****************************************************************************/
+struct CpuFeatures
+{
+    CpuFeatures() :
+        sse2(false),
+        ssse3(false),
+        avx2(false)
+    {
+#ifdef NYRA_X86
+        uint32_t registers[4] = {0, 0, 0, 0};
+        cpuid(0, registers);
+        const uint32_t maxLeaf = registers[0];
+        if (maxLeaf < 1)
+        {
+            return;
+        }
+
+        cpuid(1, registers);
+        sse2 = (registers[3] & (1u << 26)) != 0;
+        ssse3 = (registers[2] & (1u << 9)) != 0;
+
+        // AVX state must also be enabled by the operating system.
+        const bool osxsave = (registers[2] & (1u << 27)) != 0;
+        const bool avx = (registers[2] & (1u << 28)) != 0;
+        if (!osxsave || !avx || maxLeaf < 7 || (xgetbv() & 0x6) != 0x6)
+        {
+            return;
+        }
+
+        cpuid(7, registers);
+        avx2 = (registers[1] & (1u << 5)) != 0;
+#endif
+    }
+
+#ifdef NYRA_X86
+    static void cpuid(uint32_t leaf, uint32_t* registers)
+    {
+#ifdef _MSC_VER
+        int values[4];
+        __cpuidex(values, static_cast<int>(leaf), 0);
+        for (size_t ii = 0; ii < 4; ++ii)
+        {
+            registers[ii] = static_cast<uint32_t>(values[ii]);
+        }
+#else
+        __cpuid_count(leaf, 0,
+                      registers[0], registers[1], registers[2], registers[3]);
+#endif
+    }
+
+    static uint64_t xgetbv()
+    {
+#ifdef _MSC_VER
+        return _xgetbv(0);
+#else
+        uint32_t eax;
+        uint32_t edx;
+        __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+        return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+    }
+#endif
+
+    bool sse2;
+    bool ssse3;
+    bool avx2;
+};
+
+/*****************************************************************************/
+const CpuFeatures& getFeatures()
+{
+    static const CpuFeatures features;
+    return features;
+}
+}
+
+namespace nyra
+{
+namespace core
+{
+/*****************************************************************************/
+bool hasSSE2()
+{
+    return getFeatures().sse2;
+}
+
+/*****************************************************************************/
+bool hasSSSE3()
+{
+    return getFeatures().ssse3;
+}
+
+/*****************************************************************************/
+bool hasAVX2()
+{
+    return getFeatures().avx2;
+}
+}
+}
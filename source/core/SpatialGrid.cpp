@@ -0,0 +1,381 @@
+/******************************************************************************
+ * The MIT License(MIT)
+ *
+ * Copyright(c) 2015 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+#include <cmath>
+#include <algorithm>
+#include <core/SpatialGrid.h>
+#include <core/Exception.h>
+
+namespace
+{
+// Cell coordinates are clamped so points far outside any sensible world
+// still map to a cell instead of overflowing.
+const float MAX_COORDINATE = 1073741824.0f;
+
+float distanceSquared(const nyra::core::Vector2F& lhs,
+                      const nyra::core::Vector2F& rhs)
+{
+    const float x = lhs.x() - rhs.x();
+    const float y = lhs.y() - rhs.y();
+    return x * x + y * y;
+}
+}
+
+namespace nyra
+{
+namespace core
+{
+/*****************************************************************************/
+SpatialGrid::SpatialGrid(float cellSize) :
+    mCellSize(cellSize),
+    mInverseCellSize(1.0f / cellSize),
+    mSize(0)
+{
+    if (!(cellSize > 0.0f))
+    {
+        throw Exception("Grid cell size must be positive.");
+    }
+}
+
+/*****************************************************************************/
+int32_t SpatialGrid::getCoordinate(float value) const
+{
+    const float scaled = std::floor(value * mInverseCellSize);
+    return static_cast<int32_t>(std::max(-MAX_COORDINATE,
+                                         std::min(scaled, MAX_COORDINATE)));
+}
+
+/*****************************************************************************/
+void SpatialGrid::build(const Vector2F* positions,
+                        size_t count,
+                        ThreadPool* pool)
+{
+    clear();
+    mEntries.resize(count);
+    mSize = count;
+
+    // Find every point's cell in parallel, then sort so each cell's points
+    // are next to each other and every cell can be filled in one go.
+    std::vector<std::pair<uint64_t, Id> > order(count);
+    auto findCells = [&](size_t begin, size_t end)
+    {
+        for (size_t ii = begin; ii < end; ++ii)
+        {
+            order[ii] = std::make_pair(getCell(positions[ii]),
+                                       static_cast<Id>(ii));
+        }
+    };
+
+    if (pool)
+    {
+        pool->parallelFor(count, 16384, findCells);
+    }
+    else
+    {
+        findCells(0, count);
+    }
+    std::sort(order.begin(), order.end());
+
+    std::vector<std::pair<size_t, Cell*> > runs;
+    for (size_t ii = 0; ii < count;)
+    {
+        size_t end = ii + 1;
+        while (end < count && order[end].first == order[ii].first)
+        {
+            ++end;
+        }
+
+        Cell& cell = mCells[order[ii].first];
+        cell.resize(end - ii);
+        runs.push_back(std::make_pair(ii, &cell));
+        ii = end;
+    }
+
+    auto fillCells = [&](size_t begin, size_t end)
+    {
+        for (size_t ii = begin; ii < end; ++ii)
+        {
+            Cell& cell = *runs[ii].second;
+            const size_t first = runs[ii].first;
+            for (size_t jj = 0; jj < cell.size(); ++jj)
+            {
+                const std::pair<uint64_t, Id>& point = order[first + jj];
+                cell[jj].position = positions[point.second];
+                cell[jj].id = point.second;
+
+                Entry& entry = mEntries[point.second];
+                entry.cell = point.first;
+                entry.slot = static_cast<uint32_t>(jj);
+                entry.active = true;
+            }
+        }
+    };
+
+    if (pool)
+    {
+        pool->parallelFor(runs.size(), 256, fillCells);
+    }
+    else
+    {
+        fillCells(0, runs.size());
+    }
+}
+
+/*****************************************************************************/
+void SpatialGrid::insert(Id id, const Vector2F& position)
+{
+    if (contains(id))
+    {
+        throw Exception("Point is already in the grid.");
+    }
+
+    if (id >= mEntries.size())
+    {
+        mEntries.resize(static_cast<size_t>(id) + 1);
+    }
+    addToCell(id, position, getCell(position));
+    ++mSize;
+}
+
+/*****************************************************************************/
+void SpatialGrid::update(Id id, const Vector2F& position)
+{
+    const Entry& entry = getEntry(id);
+    const uint64_t cell = getCell(position);
+    if (cell == entry.cell)
+    {
+        mCells[cell][entry.slot].position = position;
+        return;
+    }
+
+    removeFromCell(id);
+    addToCell(id, position, cell);
+}
+
+/*****************************************************************************/
+void SpatialGrid::remove(Id id)
+{
+    getEntry(id);
+    removeFromCell(id);
+    mEntries[id].active = false;
+    --mSize;
+}
+
+/*****************************************************************************/
+void SpatialGrid::clear()
+{
+    mCells.clear();
+    mEntries.clear();
+    mSize = 0;
+}
+
+/*****************************************************************************/
+const Vector2F& SpatialGrid::getPosition(Id id) const
+{
+    const Entry& entry = getEntry(id);
+    return mCells.find(entry.cell)->second[entry.slot].position;
+}
+
+/*****************************************************************************/
+const SpatialGrid::Entry& SpatialGrid::getEntry(Id id) const
+{
+    if (!contains(id))
+    {
+        throw Exception("Point is not in the grid.");
+    }
+    return mEntries[id];
+}
+
+/*****************************************************************************/
+void SpatialGrid::addToCell(Id id, const Vector2F& position, uint64_t cell)
+{
+    Cell& items = mCells[cell];
+    Entry& entry = mEntries[id];
+    entry.cell = cell;
+    entry.slot = static_cast<uint32_t>(items.size());
+    entry.active = true;
+
+    Item item;
+    item.position = position;
+    item.id = id;
+    items.push_back(item);
+}
+
+/*****************************************************************************/
+void SpatialGrid::removeFromCell(Id id)
+{
+    const Entry& entry = mEntries[id];
+    auto it = mCells.find(entry.cell);
+    Cell& items = it->second;
+
+    // Fill the hole with the last point in the cell so removal is O(1).
+    if (entry.slot + 1 != items.size())
+    {
+        items[entry.slot] = items.back();
+        mEntries[items[entry.slot].id].slot = entry.slot;
+    }
+    items.pop_back();
+
+    if (items.empty())
+    {
+        mCells.erase(it);
+    }
+}
+
+/*****************************************************************************/
+void SpatialGrid::queryRadius(const Vector2F& center,
+                              float radius,
+                              std::vector<Id>& out) const
+{
+    if (radius < 0.0f)
+    {
+        return;
+    }
+
+    const float radiusSquared = radius * radius;
+    forEachCell(getCoordinate(center.x() - radius),
+                getCoordinate(center.y() - radius),
+                getCoordinate(center.x() + radius),
+                getCoordinate(center.y() + radius),
+                [&](const Cell& cell)
+    {
+        for (size_t ii = 0; ii < cell.size(); ++ii)
+        {
+            if (distanceSquared(cell[ii].position, center) <= radiusSquared)
+            {
+                out.push_back(cell[ii].id);
+            }
+        }
+    });
+}
+
+/*****************************************************************************/
+void SpatialGrid::queryBounds(const Bounds2F& bounds,
+                              std::vector<Id>& out) const
+{
+    if (bounds.isEmpty())
+    {
+        return;
+    }
+
+    forEachCell(getCoordinate(bounds.minimum.x()),
+                getCoordinate(bounds.minimum.y()),
+                getCoordinate(bounds.maximum.x()),
+                getCoordinate(bounds.maximum.y()),
+                [&](const Cell& cell)
+    {
+        for (size_t ii = 0; ii < cell.size(); ++ii)
+        {
+            if (bounds.contains(cell[ii].position))
+            {
+                out.push_back(cell[ii].id);
+            }
+        }
+    });
+}
+
+/*****************************************************************************/
+void SpatialGrid::addNearest(const Cell& cell,
+                             const Vector2F& center,
+                             size_t count,
+                             NearestHeap& heap) const
+{
+    for (size_t ii = 0; ii < cell.size(); ++ii)
+    {
+        const float distance = distanceSquared(cell[ii].position, center);
+        if (heap.size() < count)
+        {
+            heap.push_back(std::make_pair(distance, cell[ii].id));
+            std::push_heap(heap.begin(), heap.end());
+        }
+        else if (distance < heap.front().first)
+        {
+            std::pop_heap(heap.begin(), heap.end());
+            heap.back() = std::make_pair(distance, cell[ii].id);
+            std::push_heap(heap.begin(), heap.end());
+        }
+    }
+}
+
+/*****************************************************************************/
+void SpatialGrid::queryNearest(const Vector2F& center,
+                               size_t count,
+                               std::vector<Id>& out) const
+{
+    count = std::min(count, mSize);
+    if (count == 0)
+    {
+        return;
+    }
+
+    // Search square rings of cells outward from the center. After ring n
+    // every point not yet seen is at least n cells away.
+    NearestHeap heap;
+    heap.reserve(count + 1);
+    const int64_t centerX = getCoordinate(center.x());
+    const int64_t centerY = getCoordinate(center.y());
+    for (int64_t ring = 0;; ++ring)
+    {
+        const uint64_t side = static_cast<uint64_t>(ring * 2 + 1);
+        if (side * side > mCells.size() * 2)
+        {
+            // The rings now cover far more cells than are occupied so it
+            // is cheaper to check everything.
+            heap.clear();
+            for (auto it = mCells.begin(); it != mCells.end(); ++it)
+            {
+                addNearest(it->second, center, count, heap);
+            }
+            break;
+        }
+
+        for (int64_t x = centerX - ring; x <= centerX + ring; ++x)
+        {
+            const bool edge = x == centerX - ring || x == centerX + ring;
+            const int64_t step = edge ? 1 : ring * 2;
+            for (int64_t y = centerY - ring; y <= centerY + ring; y += step)
+            {
+                auto it = mCells.find(makeCell(static_cast<int32_t>(x),
+                                               static_cast<int32_t>(y)));
+                if (it != mCells.end())
+                {
+                    addNearest(it->second, center, count, heap);
+                }
+            }
+        }
+
+        const float reach = static_cast<float>(ring) * mCellSize;
+        if (heap.size() == count && heap.front().first <= reach * reach)
+        {
+            break;
+        }
+    }
+
+    std::sort_heap(heap.begin(), heap.end());
+    for (size_t ii = 0; ii < heap.size(); ++ii)
+    {
+        out.push_back(heap[ii].second);
+    }
+}
+}
+}
@@ -22,11 +22,101 @@
  * IN THE SOFTWARE.
  *****************************************************************************/
 #include <core/StringConvert.h>
+#include <core/Simd.h>
+
+#ifdef NYRA_X86
+#include <immintrin.h>
+#endif
+
+namespace
+{
+/*****************************************************************************/
+struct HexTable
+{
+    HexTable()
+    {
+        static const char digits[] = "0123456789ABCDEF";
+        for (size_t ii = 0; ii < 256; ++ii)
+        {
+            pairs[ii * 2] = digits[ii >> 4];
+            pairs[ii * 2 + 1] = digits[ii & 0xF];
+        }
+    }
+
+    char pairs[512];
+};
+
+/*****************************************************************************/
+void hexEncodeScalar(const uint8_t* data, size_t size, char* out)
+{
+    static const HexTable table;
+    for (size_t ii = 0; ii < size; ++ii)
+    {
+        const char* pair = &table.pairs[data[ii] * 2];
+        out[ii * 2] = pair[0];
+        out[ii * 2 + 1] = pair[1];
+    }
+}
+
+#ifdef NYRA_X86
+/*****************************************************************************/
+NYRA_TARGET("ssse3")
+void hexEncodeSSSE3(const uint8_t* data, size_t size, char* out)
+{
+    // Each nibble is used as a shuffle index into the 16 hex digits.
+    const __m128i digits = _mm_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7',
+                                         '8', '9', 'A', 'B', 'C', 'D', 'E', 'F');
+    const __m128i lowMask = _mm_set1_epi8(0x0F);
+
+    size_t ii = 0;
+    for (; ii + 16 <= size; ii += 16)
+    {
+        const __m128i bytes = _mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(data + ii));
+        const __m128i high = _mm_and_si128(_mm_srli_epi16(bytes, 4), lowMask);
+        const __m128i low = _mm_and_si128(bytes, lowMask);
+        const __m128i highDigits = _mm_shuffle_epi8(digits, high);
+        const __m128i lowDigits = _mm_shuffle_epi8(digits, low);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + ii * 2),
+                         _mm_unpacklo_epi8(highDigits, lowDigits));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + ii * 2 + 16),
+                         _mm_unpackhi_epi8(highDigits, lowDigits));
+    }
+
+    hexEncodeScalar(data + ii, size - ii, out + ii * 2);
+}
+#endif
+}
 
 namespace nyra
 {
 namespace core
 {
+/*****************************************************************************/
+void hexEncode(const void* data, size_t size, char* out)
+{
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+#ifdef NYRA_X86
+    if (size >= 16 && hasSSSE3())
+    {
+        hexEncodeSSSE3(bytes, size, out);
+        return;
+    }
+#endif
+    hexEncodeScalar(bytes, size, out);
+}
+
+/*****************************************************************************/
+std::string toHexString(const std::vector<uint8_t>& data)
+{
+    std::string ret(data.size() * 2, '\0');
+    if (!data.empty())
+    {
+        hexEncode(data.data(), data.size(), &ret[0]);
+    }
+    return ret;
+}
+
 template<> bool toType<bool> (const std::string& s)
 {
     // TODO: Covert all character to lower case and check numeric values.
@@ -43,6 +133,23 @@ template<> std::string toType<std::string> (const std::string& s)
     return s;
 }
 
+template<> bool tryToType<bool>(std::string_view s, bool& value)
+{
+    if (s == "true")
+        value = true;
+    else if (s == "false")
+        value = false;
+    else
+        return false;
+    return true;
+}
+
+template<> bool tryToType<std::string>(std::string_view s, std::string& value)
+{
+    value.assign(s.data(), s.size());
+    return true;
+}
+
 template<> size_t getPrecision(const float&)
 {
     return std::numeric_limits<float>::digits10;
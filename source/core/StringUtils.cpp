@@ -21,27 +21,228 @@
  * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
  * IN THE SOFTWARE.
  *****************************************************************************/
+#include <string.h>
 #include <core/StringUtils.h>
+#include <core/Simd.h>
+
+#ifdef NYRA_X86
+#include <immintrin.h>
+#endif
+
+namespace
+{
+/*
+ *  Finds occurrences of a character starting at position and writes their
+ *  offsets to out until either the end of the data is reached or out is
+ *  full. position is updated so the next call picks up where this one
+ *  stopped.
+ */
+typedef size_t (*FindCharFunc)(const char* data,
+                               size_t size,
+                               size_t& position,
+                               char character,
+                               size_t* out,
+                               size_t capacity);
+
+/*****************************************************************************/
+size_t findCharScalar(const char* data,
+                      size_t size,
+                      size_t& position,
+                      char character,
+                      size_t* out,
+                      size_t capacity)
+{
+    size_t count = 0;
+    while (position < size && count < capacity)
+    {
+        const void* found = memchr(data + position, character, size - position);
+        if (!found)
+        {
+            position = size;
+            break;
+        }
+
+        out[count] = static_cast<size_t>(static_cast<const char*>(found) - data);
+        position = out[count] + 1;
+        ++count;
+    }
+    return count;
+}
+
+#ifdef NYRA_X86
+/*****************************************************************************/
+NYRA_TARGET("sse2")
+size_t findCharSSE2(const char* data,
+                    size_t size,
+                    size_t& position,
+                    char character,
+                    size_t* out,
+                    size_t capacity)
+{
+    const __m128i needle = _mm_set1_epi8(character);
+    size_t count = 0;
+    size_t ii = position;
+    for (; ii + 16 <= size; ii += 16)
+    {
+        const __m128i block = _mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(data + ii));
+        uint32_t mask = static_cast<uint32_t>(
+                _mm_movemask_epi8(_mm_cmpeq_epi8(block, needle)));
+        while (mask)
+        {
+            const size_t offset = ii + nyra::core::countTrailingZeros(mask);
+            if (count == capacity)
+            {
+                position = offset;
+                return count;
+            }
+            out[count++] = offset;
+            mask &= mask - 1;
+        }
+    }
+
+    position = ii;
+    return count + findCharScalar(data, size, position, character,
+                                  out + count, capacity - count);
+}
+
+/*****************************************************************************/
+NYRA_TARGET("avx2")
+size_t findCharAVX2(const char* data,
+                    size_t size,
+                    size_t& position,
+                    char character,
+                    size_t* out,
+                    size_t capacity)
+{
+    const __m256i needle = _mm256_set1_epi8(character);
+    size_t count = 0;
+    size_t ii = position;
+    for (; ii + 32 <= size; ii += 32)
+    {
+        const __m256i block = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(data + ii));
+        uint32_t mask = static_cast<uint32_t>(
+                _mm256_movemask_epi8(_mm256_cmpeq_epi8(block, needle)));
+        while (mask)
+        {
+            const size_t offset = ii + nyra::core::countTrailingZeros(mask);
+            if (count == capacity)
+            {
+                position = offset;
+                return count;
+            }
+            out[count++] = offset;
+            mask &= mask - 1;
+        }
+    }
+
+    position = ii;
+    return count + findCharScalar(data, size, position, character,
+                                  out + count, capacity - count);
+}
+#endif
+
+/*****************************************************************************/
+FindCharFunc getFindChar()
+{
+#ifdef NYRA_X86
+    static const FindCharFunc func = nyra::core::hasAVX2() ? findCharAVX2 :
+                                     nyra::core::hasSSE2() ? findCharSSE2 :
+                                                             findCharScalar;
+    return func;
+#else
+    return findCharScalar;
+#endif
+}
+
+/*****************************************************************************/
+template <typename FuncT>
+void forEachMatch(std::string_view s, std::string_view delim, FuncT func)
+{
+    if (delim.empty() || delim.size() > s.size())
+    {
+        return;
+    }
+
+    // Candidates are found in bulk by searching for the first character of
+    // the deliminator and then verified. Only offsets where the whole
+    // deliminator still fits are searched.
+    const FindCharFunc findChar = getFindChar();
+    const size_t searchSize = s.size() - delim.size() + 1;
+    const size_t tailSize = delim.size() - 1;
+    size_t candidates[256];
+    size_t position = 0;
+    size_t next = 0;
+    while (position < searchSize)
+    {
+        const size_t count = findChar(s.data(),
+                                      searchSize,
+                                      position,
+                                      delim[0],
+                                      candidates,
+                                      sizeof(candidates) / sizeof(size_t));
+        for (size_t ii = 0; ii < count; ++ii)
+        {
+            const size_t offset = candidates[ii];
+            if (offset < next)
+            {
+                continue;
+            }
+
+            if (tailSize == 0 ||
+                memcmp(s.data() + offset + 1, delim.data() + 1, tailSize) == 0)
+            {
+                func(offset);
+                next = offset + delim.size();
+            }
+        }
+    }
+}
+}
 
 namespace nyra
 {
 namespace core
 {
+/*****************************************************************************/
+void findAll(std::string_view s,
+             std::string_view delim,
+             std::vector<size_t>& ret)
+{
+    forEachMatch(s, delim, [&ret](size_t offset)
+    {
+        ret.push_back(offset);
+    });
+}
+
+/*****************************************************************************/
+void split(std::string_view s,
+           std::string_view delim,
+           std::vector<std::string_view>& ret)
+{
+    size_t start = 0;
+    forEachMatch(s, delim, [&](size_t offset)
+    {
+        ret.push_back(s.substr(start, offset - start));
+        start = offset + delim.size();
+    });
+    ret.push_back(s.substr(start));
+}
+
 /*****************************************************************************/
 void split(const std::string& s,
            const std::string& delim,
            std::vector<std::string>& ret)
 {
-    std::string sCopy(s);
-    size_t pos = 0;
-    std::string token;
-    while ((pos = sCopy.find(delim)) != std::string::npos)
+    const std::string_view view(s);
+    size_t start = 0;
+    forEachMatch(view, delim, [&](size_t offset)
     {
-        token = sCopy.substr(0, pos);
-        ret.push_back(token);
-        sCopy.erase(0, pos + delim.size());
-    }
-    ret.push_back(sCopy);
+        ret.push_back(std::string(view.substr(start, offset - start)));
+        start = offset + delim.size();
+    });
+    ret.push_back(std::string(view.substr(start)));
 }
 }
 }
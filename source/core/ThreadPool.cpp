@@ -0,0 +1,121 @@
+/******************************************************************************
+ * The MIT License(MIT)
+ *
+ * Copyright(c) 2015 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+#include <algorithm>
+#include <core/ThreadPool.h>
+
+namespace nyra
+{
+namespace core
+{
+/*****************************************************************************/
+ThreadPool::ThreadPool(size_t numThreads) :
+    mStop(false)
+{
+    if (numThreads == 0)
+    {
+        numThreads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    }
+
+    // If a thread fails to start, the ones already running have to be
+    // joined before mThreads is destroyed or std::terminate is called.
+    try
+    {
+        mThreads.reserve(numThreads);
+        for (size_t ii = 0; ii < numThreads; ++ii)
+        {
+            mThreads.push_back(std::thread(&ThreadPool::run, this));
+        }
+    }
+    catch (...)
+    {
+        stop();
+        throw;
+    }
+}
+
+/*****************************************************************************/
+ThreadPool::~ThreadPool()
+{
+    stop();
+}
+
+/*****************************************************************************/
+size_t ThreadPool::getNumPending()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mTasks.size();
+}
+
+/*****************************************************************************/
+void ThreadPool::push(std::function<void()>&& task)
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mTasks.push(std::move(task));
+    }
+    mCondition.notify_one();
+}
+
+/*****************************************************************************/
+void ThreadPool::run()
+{
+    while (true)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mCondition.wait(lock, [this]()
+            {
+                return mStop || !mTasks.empty();
+            });
+
+            // Drain the queue before stopping.
+            if (mTasks.empty())
+            {
+                return;
+            }
+
+            task = std::move(mTasks.front());
+            mTasks.pop();
+        }
+        task();
+    }
+}
+
+/*****************************************************************************/
+void ThreadPool::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStop = true;
+    }
+    mCondition.notify_all();
+
+    for (size_t ii = 0; ii < mThreads.size(); ++ii)
+    {
+        mThreads[ii].join();
+    }
+}
+}
+}
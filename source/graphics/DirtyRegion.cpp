@@ -0,0 +1,148 @@
+/******************************************************************************
+ * The MIT License(MIT)
+ *
+ * Copyright(c) 2015 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+#include <algorithm>
+#include <limits>
+#include <graphics/DirtyRegion.h>
+
+namespace nyra
+{
+namespace graphics
+{
+/*****************************************************************************/
+DirtyRegion::DirtyRegion(size_t maxRects) :
+    mMaxRects(std::max<size_t>(maxRects, 1))
+{
+}
+
+/*****************************************************************************/
+void DirtyRegion::add(const Rect& rect)
+{
+    if (rect.isEmpty())
+    {
+        return;
+    }
+
+    // Absorb every rectangle the new one touches. Growing the rectangle
+    // can make it touch ones that were checked earlier, so start over
+    // after each merge.
+    Rect merged = rect;
+    size_t ii = 0;
+    while (ii < mRects.size())
+    {
+        if (mRects[ii].contains(merged))
+        {
+            return;
+        }
+
+        if (mRects[ii].touches(merged))
+        {
+            merged = merged.unite(mRects[ii]);
+            mRects[ii] = mRects.back();
+            mRects.pop_back();
+            ii = 0;
+        }
+        else
+        {
+            ++ii;
+        }
+    }
+
+    mRects.push_back(merged);
+    while (mRects.size() > mMaxRects)
+    {
+        mergeCheapestPair();
+    }
+}
+
+/*****************************************************************************/
+void DirtyRegion::clip(const Rect& bounds)
+{
+    size_t used = 0;
+    for (size_t ii = 0; ii < mRects.size(); ++ii)
+    {
+        const Rect clipped = mRects[ii].intersect(bounds);
+        if (!clipped.isEmpty())
+        {
+            mRects[used++] = clipped;
+        }
+    }
+    mRects.resize(used);
+}
+
+/*****************************************************************************/
+Rect DirtyRegion::getBounds() const
+{
+    Rect bounds;
+    for (size_t ii = 0; ii < mRects.size(); ++ii)
+    {
+        bounds = bounds.unite(mRects[ii]);
+    }
+    return bounds;
+}
+
+/*****************************************************************************/
+int64_t DirtyRegion::getArea() const
+{
+    // The rectangles never overlap so their areas can simply be added.
+    int64_t area = 0;
+    for (size_t ii = 0; ii < mRects.size(); ++ii)
+    {
+        area += mRects[ii].getArea();
+    }
+    return area;
+}
+
+/*****************************************************************************/
+void DirtyRegion::mergeCheapestPair()
+{
+    size_t first = 0;
+    size_t second = 1;
+    int64_t bestCost = std::numeric_limits<int64_t>::max();
+    for (size_t ii = 0; ii < mRects.size(); ++ii)
+    {
+        for (size_t jj = ii + 1; jj < mRects.size(); ++jj)
+        {
+            const int64_t cost = mRects[ii].unite(mRects[jj]).getArea() -
+                                 mRects[ii].getArea() -
+                                 mRects[jj].getArea();
+            if (cost < bestCost)
+            {
+                bestCost = cost;
+                first = ii;
+                second = jj;
+            }
+        }
+    }
+
+    // The combined rectangle may now touch others, so add it again rather
+    // than storing it in place.
+    const Rect merged = mRects[first].unite(mRects[second]);
+    mRects[second] = mRects.back();
+    mRects.pop_back();
+    mRects[first] = mRects.back();
+    mRects.pop_back();
+    add(merged);
+}
+}
+}
@@ -0,0 +1,109 @@
+/******************************************************************************
+ * The MIT License(MIT)
+ *
+ * Copyright(c) 2015 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+#include <algorithm>
+#include <thread>
+#include <graphics/FramePacer.h>
+#include <core/Exception.h>
+
+namespace
+{
+/*****************************************************************************/
+nyra::graphics::FramePacer::Clock::duration toDuration(double seconds)
+{
+    return std::chrono::duration_cast<
+            nyra::graphics::FramePacer::Clock::duration>(
+                    std::chrono::duration<double>(seconds));
+}
+}
+
+namespace nyra
+{
+namespace graphics
+{
+/*****************************************************************************/
+FramePacer::FramePacer(double rate) :
+    mRate(0.0),
+    mPeriod(Clock::duration::zero()),
+    mSpinTime(toDuration(0.002)),
+    mStarted(false)
+{
+    setRate(rate);
+}
+
+/*****************************************************************************/
+void FramePacer::setRate(double rate)
+{
+    if (rate < 0.0)
+    {
+        throw core::Exception("Frame rate cannot be negative");
+    }
+
+    mRate = rate;
+    mPeriod = rate > 0.0 ? toDuration(1.0 / rate) : Clock::duration::zero();
+    mStarted = false;
+}
+
+/*****************************************************************************/
+void FramePacer::setSpinTime(double seconds)
+{
+    mSpinTime = toDuration(std::max(seconds, 0.0));
+}
+
+/*****************************************************************************/
+size_t FramePacer::wait()
+{
+    if (mPeriod == Clock::duration::zero())
+    {
+        return 0;
+    }
+
+    const Clock::time_point now = Clock::now();
+    if (!mStarted)
+    {
+        mDeadline = now + mPeriod;
+        mStarted = true;
+    }
+
+    if (now >= mDeadline)
+    {
+        const size_t missed = 1 + static_cast<size_t>((now - mDeadline) /
+                                                      mPeriod);
+        mDeadline = missed > 1 ? now + mPeriod : mDeadline + mPeriod;
+        return missed;
+    }
+
+    if (mDeadline - now > mSpinTime)
+    {
+        std::this_thread::sleep_until(mDeadline - mSpinTime);
+    }
+    while (Clock::now() < mDeadline)
+    {
+        std::this_thread::yield();
+    }
+
+    mDeadline += mPeriod;
+    return 0;
+}
+}
+}
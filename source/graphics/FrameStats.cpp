@@ -0,0 +1,144 @@
+/******************************************************************************
+ * The MIT License(MIT)
+ *
+ * Copyright(c) 2015 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+#include <algorithm>
+#include <cmath>
+#include <graphics/FrameStats.h>
+
+namespace nyra
+{
+namespace graphics
+{
+/*****************************************************************************/
+FrameStats::FrameStats(size_t historySize) :
+    mHistorySize(std::max<size_t>(historySize, 1)),
+    mNext(0),
+    mNumFrames(0),
+    mNumDropped(0)
+{
+    for (size_t ii = 0; ii < NUM_STAGES; ++ii)
+    {
+        mHistory[ii].assign(mHistorySize, 0.0);
+        mCurrent[ii].store(0, std::memory_order_relaxed);
+    }
+}
+
+/*****************************************************************************/
+FrameStats::Clock::time_point FrameStats::addStageTime(
+        Stage stage,
+        Clock::time_point start)
+{
+    const Clock::time_point now = Clock::now();
+    mCurrent[stage].fetch_add(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    now - start).count(),
+            std::memory_order_relaxed);
+    return now;
+}
+
+/*****************************************************************************/
+void FrameStats::endFrame(double frameTime, size_t dropped)
+{
+    for (size_t ii = 0; ii < FRAME; ++ii)
+    {
+        mHistory[ii][mNext] =
+                mCurrent[ii].exchange(0, std::memory_order_relaxed) * 1e-9;
+    }
+    mHistory[FRAME][mNext] = frameTime;
+
+    mNext = (mNext + 1) % mHistorySize;
+    ++mNumFrames;
+    mNumDropped += dropped;
+}
+
+/*****************************************************************************/
+double FrameStats::getPercentile(Stage stage, double percent) const
+{
+    const size_t count = getHistoryCount();
+    if (count == 0)
+    {
+        return 0.0;
+    }
+
+    // Nearest rank, so the result is always a time that really happened.
+    const double clamped = std::min(std::max(percent, 0.0), 100.0);
+    const size_t rank = static_cast<size_t>(
+            std::ceil(clamped / 100.0 * count));
+    const size_t index = rank ? rank - 1 : 0;
+
+    mScratch.assign(mHistory[stage].begin(),
+                    mHistory[stage].begin() + count);
+    std::nth_element(mScratch.begin(),
+                     mScratch.begin() + index,
+                     mScratch.end());
+    return mScratch[index];
+}
+
+/*****************************************************************************/
+double FrameStats::getAverage(Stage stage) const
+{
+    const size_t count = getHistoryCount();
+    if (count == 0)
+    {
+        return 0.0;
+    }
+
+    double total = 0.0;
+    for (size_t ii = 0; ii < count; ++ii)
+    {
+        total += mHistory[stage][ii];
+    }
+    return total / count;
+}
+
+/*****************************************************************************/
+double FrameStats::getLast(Stage stage) const
+{
+    if (mNumFrames == 0)
+    {
+        return 0.0;
+    }
+    return mHistory[stage][(mNext + mHistorySize - 1) % mHistorySize];
+}
+
+/*****************************************************************************/
+void FrameStats::reset()
+{
+    for (size_t ii = 0; ii < NUM_STAGES; ++ii)
+    {
+        std::fill(mHistory[ii].begin(), mHistory[ii].end(), 0.0);
+        mCurrent[ii].store(0, std::memory_order_relaxed);
+    }
+    mNext = 0;
+    mNumFrames = 0;
+    mNumDropped = 0;
+}
+
+/*****************************************************************************/
+size_t FrameStats::getHistoryCount() const
+{
+    // Until the history wraps only the first mNumFrames entries are used.
+    return std::min(mNumFrames, mHistorySize);
+}
+}
+}
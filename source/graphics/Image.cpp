@@ -0,0 +1,172 @@
+/******************************************************************************
+ * The MIT License(MIT)
+ *
+ * Copyright(c) 2015 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+#include <string.h>
+#include <algorithm>
+#include <graphics/Image.h>
+#include <core/File.h>
+#include <core/Exception.h>
+
+namespace
+{
+const size_t TGA_HEADER_SIZE = 18;
+
+enum TgaType
+{
+    TGA_COLOR = 2,
+    TGA_GRAY = 3,
+    TGA_COLOR_RLE = 10,
+    TGA_GRAY_RLE = 11
+};
+
+// Bit 5 of the descriptor byte is set when the first row is the top one.
+const uint8_t TGA_TOP_FIRST = 0x20;
+
+/*****************************************************************************/
+size_t readLittle16(const uint8_t* data)
+{
+    return data[0] | (static_cast<size_t>(data[1]) << 8);
+}
+
+/*****************************************************************************/
+void copyPixel(const uint8_t* source, size_t sourceBytes, uint8_t* destination)
+{
+    // TGA stores color as blue, green, red, so it already matches BGRA8.
+    if (sourceBytes == 3)
+    {
+        memcpy(destination, source, 3);
+        destination[3] = 255;
+    }
+    else
+    {
+        memcpy(destination, source, sourceBytes);
+    }
+}
+}
+
+namespace nyra
+{
+namespace graphics
+{
+/*****************************************************************************/
+Image readTGA(const std::string& pathname)
+{
+    const std::vector<uint8_t> file = core::readBinary(pathname);
+    if (file.size() < TGA_HEADER_SIZE)
+    {
+        throw core::Exception("TGA file is too small: " + pathname);
+    }
+
+    const uint8_t* header = &file[0];
+    const size_t idLength = header[0];
+    const uint8_t colorMapType = header[1];
+    const uint8_t type = header[2];
+    const size_t colorMapLength = readLittle16(header + 5);
+    const size_t colorMapBits = header[7];
+    const size_t width = readLittle16(header + 12);
+    const size_t height = readLittle16(header + 14);
+    const size_t bits = header[16];
+    const bool topFirst = (header[17] & TGA_TOP_FIRST) != 0;
+
+    const bool gray = type == TGA_GRAY || type == TGA_GRAY_RLE;
+    const bool rle = type == TGA_COLOR_RLE || type == TGA_GRAY_RLE;
+    if (type != TGA_COLOR && !gray && !rle)
+    {
+        throw core::Exception("Unsupported TGA image type: " + pathname);
+    }
+    if (gray ? bits != 8 : bits != 24 && bits != 32)
+    {
+        throw core::Exception("Unsupported TGA pixel size: " + pathname);
+    }
+
+    // Color maps are allowed on true color images but are not used.
+    size_t offset = TGA_HEADER_SIZE + idLength;
+    if (colorMapType)
+    {
+        offset += colorMapLength * ((colorMapBits + 7) / 8);
+    }
+
+    Image image(core::Vector2UI(width, height), gray ? GRAY8 : BGRA8);
+    const size_t sourceBytes = bits / 8;
+    const size_t bytes = getBytesPerPixel(image.format);
+    const size_t count = width * height;
+    const uint8_t* in = &file[0] + std::min(offset, file.size());
+    const uint8_t* end = &file[0] + file.size();
+
+    // Decode in file order first. Runs can cross row boundaries.
+    uint8_t* out = image.pixels.empty() ? nullptr : &image.pixels[0];
+    size_t decoded = 0;
+    while (decoded < count)
+    {
+        size_t run = count - decoded;
+        bool repeat = false;
+        if (rle)
+        {
+            if (in >= end)
+            {
+                break;
+            }
+            repeat = (*in & 0x80) != 0;
+            run = std::min<size_t>((*in & 0x7F) + 1, count - decoded);
+            ++in;
+        }
+
+        const size_t needed = (repeat ? 1 : run) * sourceBytes;
+        if (static_cast<size_t>(end - in) < needed)
+        {
+            break;
+        }
+
+        for (size_t ii = 0; ii < run; ++ii)
+        {
+            copyPixel(repeat ? in : in + ii * sourceBytes,
+                      sourceBytes,
+                      out + (decoded + ii) * bytes);
+        }
+        in += needed;
+        decoded += run;
+    }
+
+    if (decoded < count)
+    {
+        throw core::Exception("TGA file is truncated: " + pathname);
+    }
+
+    if (!topFirst && count)
+    {
+        const size_t pitch = width * bytes;
+        std::vector<uint8_t> row(pitch);
+        for (size_t ii = 0; ii < height / 2; ++ii)
+        {
+            uint8_t* top = out + ii * pitch;
+            uint8_t* bottom = out + (height - 1 - ii) * pitch;
+            memcpy(&row[0], top, pitch);
+            memcpy(top, bottom, pitch);
+            memcpy(bottom, &row[0], pitch);
+        }
+    }
+
+    return image;
+}
+}
+}
@@ -0,0 +1,511 @@
+/******************************************************************************
+ * The MIT License(MIT)
+ *
+ * Copyright(c) 2015 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <graphics/PixelFormat.h>
+#include <core/Simd.h>
+#include <core/Exception.h>
+
+#ifdef NYRA_X86
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+typedef void (*ConvertRowFunc)(const uint8_t* source,
+                               uint8_t* destination,
+                               size_t width);
+
+// Red is the first byte of an RGBA8 pixel and the third byte of a BGRA8
+// pixel. The 32 bit kernels are written once with this as a parameter.
+const size_t RED_FIRST = 0;
+const size_t RED_THIRD = 2;
+
+/*****************************************************************************/
+uint8_t expand5(uint32_t value)
+{
+    return static_cast<uint8_t>((value << 3) | (value >> 2));
+}
+
+/*****************************************************************************/
+uint8_t expand6(uint32_t value)
+{
+    return static_cast<uint8_t>((value << 2) | (value >> 4));
+}
+
+/*****************************************************************************/
+uint8_t toGray(uint32_t red, uint32_t green, uint32_t blue)
+{
+    return static_cast<uint8_t>((red * 77 + green * 150 + blue * 29 + 128) >>
+                                8);
+}
+
+/*****************************************************************************/
+void swapRedBlueScalar(const uint8_t* source, uint8_t* destination,
+                       size_t width)
+{
+    for (size_t ii = 0; ii < width; ++ii)
+    {
+        const uint8_t* in = source + ii * 4;
+        uint8_t* out = destination + ii * 4;
+        out[0] = in[2];
+        out[1] = in[1];
+        out[2] = in[0];
+        out[3] = in[3];
+    }
+}
+
+/*****************************************************************************/
+template <size_t RedT>
+void fromRGB565Scalar(const uint8_t* source, uint8_t* destination,
+                      size_t width)
+{
+    for (size_t ii = 0; ii < width; ++ii)
+    {
+        uint16_t value;
+        memcpy(&value, source + ii * 2, sizeof(value));
+        uint8_t* out = destination + ii * 4;
+        out[RedT] = expand5(value >> 11);
+        out[1] = expand6((value >> 5) & 0x3F);
+        out[2 - RedT] = expand5(value & 0x1F);
+        out[3] = 0xFF;
+    }
+}
+
+/*****************************************************************************/
+template <size_t RedT>
+void toRGB565Scalar(const uint8_t* source, uint8_t* destination,
+                    size_t width)
+{
+    for (size_t ii = 0; ii < width; ++ii)
+    {
+        const uint8_t* in = source + ii * 4;
+        const uint16_t value = static_cast<uint16_t>(
+                ((in[RedT] >> 3) << 11) | ((in[1] >> 2) << 5) |
+                (in[2 - RedT] >> 3));
+        memcpy(destination + ii * 2, &value, sizeof(value));
+    }
+}
+
+/*****************************************************************************/
+void fromGrayScalar(const uint8_t* source, uint8_t* destination,
+                    size_t width)
+{
+    for (size_t ii = 0; ii < width; ++ii)
+    {
+        uint8_t* out = destination + ii * 4;
+        out[0] = source[ii];
+        out[1] = source[ii];
+        out[2] = source[ii];
+        out[3] = 0xFF;
+    }
+}
+
+/*****************************************************************************/
+template <size_t RedT>
+void toGrayScalar(const uint8_t* source, uint8_t* destination, size_t width)
+{
+    for (size_t ii = 0; ii < width; ++ii)
+    {
+        const uint8_t* in = source + ii * 4;
+        destination[ii] = toGray(in[RedT], in[1], in[2 - RedT]);
+    }
+}
+
+#ifdef NYRA_X86
+/*****************************************************************************/
+NYRA_TARGET("sse2")
+void swapRedBlueSSE2(const uint8_t* source, uint8_t* destination,
+                     size_t width)
+{
+    const __m128i greenAlpha = _mm_set1_epi32(static_cast<int>(0xFF00FF00));
+    const __m128i low = _mm_set1_epi32(0xFF);
+    size_t ii = 0;
+    for (; ii + 4 <= width; ii += 4)
+    {
+        const __m128i pixels = _mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(source + ii * 4));
+        const __m128i first = _mm_and_si128(pixels, low);
+        const __m128i third = _mm_and_si128(_mm_srli_epi32(pixels, 16), low);
+        const __m128i swapped = _mm_or_si128(
+                _mm_and_si128(pixels, greenAlpha),
+                _mm_or_si128(_mm_slli_epi32(first, 16), third));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + ii * 4),
+                         swapped);
+    }
+    swapRedBlueScalar(source + ii * 4, destination + ii * 4, width - ii);
+}
+
+/*****************************************************************************/
+template <size_t RedT>
+NYRA_TARGET("sse2")
+void fromRGB565SSE2(const uint8_t* source, uint8_t* destination,
+                    size_t width)
+{
+    const __m128i mask5 = _mm_set1_epi16(0x1F);
+    const __m128i mask6 = _mm_set1_epi16(0x3F);
+    const __m128i alpha = _mm_set1_epi16(static_cast<short>(0xFF00));
+    size_t ii = 0;
+    for (; ii + 8 <= width; ii += 8)
+    {
+        const __m128i pixels = _mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(source + ii * 2));
+
+        // Widen each channel to 8 bits by repeating its top bits.
+        const __m128i red5 = _mm_srli_epi16(pixels, 11);
+        const __m128i green6 = _mm_and_si128(_mm_srli_epi16(pixels, 5), mask6);
+        const __m128i blue5 = _mm_and_si128(pixels, mask5);
+        const __m128i red = _mm_or_si128(_mm_slli_epi16(red5, 3),
+                                         _mm_srli_epi16(red5, 2));
+        const __m128i green = _mm_or_si128(_mm_slli_epi16(green6, 2),
+                                           _mm_srli_epi16(green6, 4));
+        const __m128i blue = _mm_or_si128(_mm_slli_epi16(blue5, 3),
+                                          _mm_srli_epi16(blue5, 2));
+
+        // Each pixel is built from a 16 bit pair for its first two bytes
+        // and a 16 bit pair for its last two.
+        const __m128i firstChannel = RedT == RED_FIRST ? red : blue;
+        const __m128i thirdChannel = RedT == RED_FIRST ? blue : red;
+        const __m128i firstHalf = _mm_or_si128(firstChannel,
+                                               _mm_slli_epi16(green, 8));
+        const __m128i secondHalf = _mm_or_si128(thirdChannel, alpha);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + ii * 4),
+                         _mm_unpacklo_epi16(firstHalf, secondHalf));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + ii * 4 + 16),
+                         _mm_unpackhi_epi16(firstHalf, secondHalf));
+    }
+    fromRGB565Scalar<RedT>(source + ii * 2, destination + ii * 4, width - ii);
+}
+
+/*****************************************************************************/
+template <size_t RedT>
+NYRA_TARGET("sse2")
+__m128i toRGB565Block(const uint8_t* source)
+{
+    const __m128i low = _mm_set1_epi32(0xFF);
+    const __m128i pixels = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(source));
+    const __m128i first = _mm_and_si128(pixels, low);
+    const __m128i green = _mm_and_si128(_mm_srli_epi32(pixels, 8), low);
+    const __m128i third = _mm_and_si128(_mm_srli_epi32(pixels, 16), low);
+    const __m128i red = RedT == RED_FIRST ? first : third;
+    const __m128i blue = RedT == RED_FIRST ? third : first;
+    return _mm_or_si128(_mm_or_si128(
+            _mm_slli_epi32(_mm_srli_epi32(red, 3), 11),
+            _mm_slli_epi32(_mm_srli_epi32(green, 2), 5)),
+            _mm_srli_epi32(blue, 3));
+}
+
+/*****************************************************************************/
+template <size_t RedT>
+NYRA_TARGET("sse2")
+void toRGB565SSE2(const uint8_t* source, uint8_t* destination, size_t width)
+{
+    // SSE2 can only pack 32 bit lanes to 16 bits with signed saturation,
+    // so values are shifted into the signed range and back.
+    const __m128i bias32 = _mm_set1_epi32(0x8000);
+    const __m128i bias16 = _mm_set1_epi16(static_cast<short>(0x8000));
+    size_t ii = 0;
+    for (; ii + 8 <= width; ii += 8)
+    {
+        const __m128i first = _mm_sub_epi32(
+                toRGB565Block<RedT>(source + ii * 4), bias32);
+        const __m128i second = _mm_sub_epi32(
+                toRGB565Block<RedT>(source + ii * 4 + 16), bias32);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + ii * 2),
+                         _mm_xor_si128(_mm_packs_epi32(first, second), bias16));
+    }
+    toRGB565Scalar<RedT>(source + ii * 4, destination + ii * 2, width - ii);
+}
+
+/*****************************************************************************/
+NYRA_TARGET("sse2")
+void fromGraySSE2(const uint8_t* source, uint8_t* destination, size_t width)
+{
+    const __m128i alpha = _mm_set1_epi8(static_cast<char>(0xFF));
+    size_t ii = 0;
+    for (; ii + 16 <= width; ii += 16)
+    {
+        const __m128i gray = _mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(source + ii));
+
+        // Pair each value with itself for the first two bytes of a pixel
+        // and with opaque alpha for the last two.
+        const __m128i grayGray[2] = {_mm_unpacklo_epi8(gray, gray),
+                                     _mm_unpackhi_epi8(gray, gray)};
+        const __m128i grayAlpha[2] = {_mm_unpacklo_epi8(gray, alpha),
+                                      _mm_unpackhi_epi8(gray, alpha)};
+        __m128i* out = reinterpret_cast<__m128i*>(destination + ii * 4);
+        for (size_t jj = 0; jj < 2; ++jj)
+        {
+            _mm_storeu_si128(out + jj * 2, _mm_unpacklo_epi16(grayGray[jj],
+                                                              grayAlpha[jj]));
+            _mm_storeu_si128(out + jj * 2 + 1,
+                             _mm_unpackhi_epi16(grayGray[jj], grayAlpha[jj]));
+        }
+    }
+    fromGrayScalar(source + ii, destination + ii * 4, width - ii);
+}
+
+/*****************************************************************************/
+template <size_t RedT>
+NYRA_TARGET("sse2")
+__m128i toGrayBlock(const uint8_t* source)
+{
+    // The first and third bytes of each pixel are multiplied and added in
+    // one step, as are the second and fourth.
+    const __m128i low = _mm_set1_epi32(0x00FF00FF);
+    const __m128i outerWeights = RedT == RED_FIRST ?
+            _mm_set1_epi32((29 << 16) | 77) : _mm_set1_epi32((77 << 16) | 29);
+    const __m128i innerWeights = _mm_set1_epi32(150);
+    const __m128i pixels = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(source));
+    const __m128i outer = _mm_madd_epi16(_mm_and_si128(pixels, low),
+                                         outerWeights);
+    const __m128i inner = _mm_madd_epi16(
+            _mm_and_si128(_mm_srli_epi32(pixels, 8), low), innerWeights);
+    return _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(outer, inner),
+                                        _mm_set1_epi32(128)), 8);
+}
+
+/*****************************************************************************/
+template <size_t RedT>
+NYRA_TARGET("sse2")
+void toGraySSE2(const uint8_t* source, uint8_t* destination, size_t width)
+{
+    size_t ii = 0;
+    for (; ii + 16 <= width; ii += 16)
+    {
+        const __m128i first = _mm_packs_epi32(
+                toGrayBlock<RedT>(source + ii * 4),
+                toGrayBlock<RedT>(source + ii * 4 + 16));
+        const __m128i second = _mm_packs_epi32(
+                toGrayBlock<RedT>(source + ii * 4 + 32),
+                toGrayBlock<RedT>(source + ii * 4 + 48));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + ii),
+                         _mm_packus_epi16(first, second));
+    }
+    toGrayScalar<RedT>(source + ii * 4, destination + ii, width - ii);
+}
+#endif
+
+/*****************************************************************************/
+template <size_t BytesT>
+void copyRow(const uint8_t* source, uint8_t* destination, size_t width)
+{
+    memcpy(destination, source, width * BytesT);
+}
+
+/*****************************************************************************/
+ConvertRowFunc getConvertRow(nyra::graphics::PixelFormat source,
+                             nyra::graphics::PixelFormat destination)
+{
+    using namespace nyra::graphics;
+
+#ifdef NYRA_X86
+    static const bool sse2 = nyra::core::hasSSE2();
+#else
+    static const bool sse2 = false;
+#endif
+
+    if (source == destination)
+    {
+        switch (source)
+        {
+        case RGBA8:
+        case BGRA8:
+            return copyRow<4>;
+        case RGB565:
+            return copyRow<2>;
+        case GRAY8:
+            return copyRow<1>;
+        }
+    }
+
+#ifdef NYRA_X86
+    if (sse2)
+    {
+        switch (source * 4 + destination)
+        {
+        case RGBA8 * 4 + BGRA8:
+        case BGRA8 * 4 + RGBA8:
+            return swapRedBlueSSE2;
+        case RGBA8 * 4 + RGB565:
+            return toRGB565SSE2<RED_FIRST>;
+        case BGRA8 * 4 + RGB565:
+            return toRGB565SSE2<RED_THIRD>;
+        case RGBA8 * 4 + GRAY8:
+            return toGraySSE2<RED_FIRST>;
+        case BGRA8 * 4 + GRAY8:
+            return toGraySSE2<RED_THIRD>;
+        case RGB565 * 4 + RGBA8:
+            return fromRGB565SSE2<RED_FIRST>;
+        case RGB565 * 4 + BGRA8:
+            return fromRGB565SSE2<RED_THIRD>;
+        case GRAY8 * 4 + RGBA8:
+        case GRAY8 * 4 + BGRA8:
+            return fromGraySSE2;
+        }
+    }
+#endif
+
+    switch (source * 4 + destination)
+    {
+    case RGBA8 * 4 + BGRA8:
+    case BGRA8 * 4 + RGBA8:
+        return swapRedBlueScalar;
+    case RGBA8 * 4 + RGB565:
+        return toRGB565Scalar<RED_FIRST>;
+    case BGRA8 * 4 + RGB565:
+        return toRGB565Scalar<RED_THIRD>;
+    case RGBA8 * 4 + GRAY8:
+        return toGrayScalar<RED_FIRST>;
+    case BGRA8 * 4 + GRAY8:
+        return toGrayScalar<RED_THIRD>;
+    case RGB565 * 4 + RGBA8:
+        return fromRGB565Scalar<RED_FIRST>;
+    case RGB565 * 4 + BGRA8:
+        return fromRGB565Scalar<RED_THIRD>;
+    case GRAY8 * 4 + RGBA8:
+    case GRAY8 * 4 + BGRA8:
+        return fromGrayScalar;
+    }
+    return nullptr;
+}
+}
+
+namespace nyra
+{
+namespace graphics
+{
+/*****************************************************************************/
+size_t getBytesPerPixel(PixelFormat format)
+{
+    switch (format)
+    {
+    case RGBA8:
+    case BGRA8:
+        return 4;
+    case RGB565:
+        return 2;
+    case GRAY8:
+        return 1;
+    }
+    throw core::Exception("Invalid pixel format.");
+}
+
+/*****************************************************************************/
+void convertPixels(const PixelBuffer& source,
+                   void* destination,
+                   size_t destinationPitch,
+                   PixelFormat destinationFormat)
+{
+    const size_t width = source.size.x();
+    const size_t height = source.size.y();
+    const uint8_t* in = static_cast<const uint8_t*>(source.pixels);
+    uint8_t* out = static_cast<uint8_t*>(destination);
+
+    const ConvertRowFunc convert = getConvertRow(source.format,
+                                                 destinationFormat);
+    if (convert)
+    {
+        for (size_t row = 0; row < height; ++row)
+        {
+            convert(in + row * source.pitch,
+                    out + row * destinationPitch,
+                    width);
+        }
+        return;
+    }
+
+    // Conversions between RGB565 and GRAY8 go through RGBA8 in small
+    // pieces that stay in cache.
+    const size_t BLOCK = 256;
+    uint8_t block[BLOCK * 4];
+    const ConvertRowFunc toBlock = getConvertRow(source.format, RGBA8);
+    const ConvertRowFunc fromBlock = getConvertRow(RGBA8, destinationFormat);
+    const size_t inBytes = getBytesPerPixel(source.format);
+    const size_t outBytes = getBytesPerPixel(destinationFormat);
+    for (size_t row = 0; row < height; ++row)
+    {
+        const uint8_t* inRow = in + row * source.pitch;
+        uint8_t* outRow = out + row * destinationPitch;
+        for (size_t ii = 0; ii < width; ii += BLOCK)
+        {
+            const size_t count = std::min(BLOCK, width - ii);
+            toBlock(inRow + ii * inBytes, block, count);
+            fromBlock(block, outRow + ii * outBytes, count);
+        }
+    }
+}
+/*****************************************************************************/
+void convertRects(const PixelBuffer& source,
+                  const std::vector<Rect>& rects,
+                  void* destination,
+                  const core::Vector2UI& destinationSize,
+                  size_t destinationPitch,
+                  PixelFormat destinationFormat,
+                  std::vector<Rect>* converted)
+{
+    const size_t sourceBytes = getBytesPerPixel(source.format);
+    const size_t destinationBytes = getBytesPerPixel(destinationFormat);
+    const Rect bounds(0,
+                      0,
+                      static_cast<int32_t>(std::min(source.size.x(),
+                                                    destinationSize.x())),
+                      static_cast<int32_t>(std::min(source.size.y(),
+                                                    destinationSize.y())));
+
+    // Each rectangle is converted on its own so only the changed spans of
+    // each row are touched.
+    for (size_t ii = 0; ii < rects.size(); ++ii)
+    {
+        const Rect rect = rects[ii].intersect(bounds);
+        if (rect.isEmpty())
+        {
+            continue;
+        }
+
+        const PixelBuffer part(
+                static_cast<const uint8_t*>(source.pixels) +
+                        rect.y * source.pitch + rect.x * sourceBytes,
+                core::Vector2UI(rect.width, rect.height),
+                source.format,
+                source.pitch);
+        convertPixels(part,
+                      static_cast<uint8_t*>(destination) +
+                              rect.y * destinationPitch +
+                              rect.x * destinationBytes,
+                      destinationPitch,
+                      destinationFormat);
+
+        if (converted)
+        {
+            converted->push_back(rect);
+        }
+    }
+}
+}
+}
@@ -0,0 +1,137 @@
+/******************************************************************************
+ * The MIT License(MIT)
+ *
+ * Copyright(c) 2015 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+#include <algorithm>
+#include <graphics/PresentThread.h>
+
+namespace nyra
+{
+namespace graphics
+{
+/*****************************************************************************/
+PresentThread::PresentThread(Window& window,
+                             const core::Vector2UI& size,
+                             PixelFormat format) :
+    mWindow(window),
+    mSize(size),
+    mFormat(format),
+    // Rows start on 16 byte boundaries. The buffers are 64 byte aligned,
+    // so the 16 byte loads and stores of the conversion kernels never
+    // straddle two cache lines.
+    mPitch((size.x() * getBytesPerPixel(format) + 15) & ~size_t(15)),
+    mBack(0),
+    mFront(1),
+    mReady(2),
+    mNumPresented(0),
+    mNumDropped(0),
+    mWaiting(false),
+    mStop(false),
+    mFailed(false)
+{
+    for (size_t ii = 0; ii < NUM_BUFFERS; ++ii)
+    {
+        mBuffers[ii].resize(std::max<size_t>(mPitch * size.y(), 1));
+    }
+
+    mThread = std::thread(&PresentThread::run, this);
+}
+
+/*****************************************************************************/
+PresentThread::~PresentThread()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStop = true;
+    }
+    mCondition.notify_one();
+    mThread.join();
+}
+
+/*****************************************************************************/
+void PresentThread::submit()
+{
+    if (mFailed.load(std::memory_order_acquire))
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        std::rethrow_exception(mError);
+    }
+
+    const uint32_t previous = mReady.exchange(mBack | FRESH);
+    mBack = previous & INDEX_MASK;
+    if (previous & FRESH)
+    {
+        mNumDropped.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Both sides use sequentially consistent operations on mReady and
+    // mWaiting, so either the presentation thread sees the new frame
+    // before sleeping or this sees that it is asleep. Taking the lock
+    // makes sure it is inside wait before it is notified.
+    if (mWaiting.load())
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+        }
+        mCondition.notify_one();
+    }
+}
+
+/*****************************************************************************/
+bool PresentThread::waitForFrame()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    mWaiting.store(true);
+    while (!mStop && !(mReady.load() & FRESH))
+    {
+        mCondition.wait(lock);
+    }
+    mWaiting.store(false);
+    return !mStop;
+}
+
+/*****************************************************************************/
+void PresentThread::run()
+{
+    while (waitForFrame())
+    {
+        mFront = mReady.exchange(mFront) & INDEX_MASK;
+
+        try
+        {
+            mWindow.showBuffer(PixelBuffer(&mBuffers[mFront][0],
+                                           mSize,
+                                           mFormat,
+                                           mPitch));
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mError = std::current_exception();
+            mFailed.store(true, std::memory_order_release);
+            return;
+        }
+        mNumPresented.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+}
+}
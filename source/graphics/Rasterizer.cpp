@@ -0,0 +1,985 @@
+/******************************************************************************
+ * The MIT License(MIT)
+ *
+ * Copyright(c) 2015 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+#include <string.h>
+#include <algorithm>
+#include <cmath>
+#include <graphics/Rasterizer.h>
+#include <core/Simd.h>
+#include <core/Exception.h>
+
+#ifdef NYRA_X86
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+typedef void (*FillRowFunc)(uint8_t* row, size_t width, const uint8_t* color);
+
+typedef void (*BlitRowFunc)(const uint8_t* source,
+                            uint8_t* destination,
+                            size_t width);
+
+// Alpha is the last byte of both RGBA8 and BGRA8 pixels.
+const size_t ALPHA = 3;
+
+// Points are clamped to this so pixel math cannot overflow. Only shapes
+// reaching millions of pixels off the target are changed by it.
+const float COORDINATE_LIMIT = 16777216.0f;
+
+typedef void (*GradientRowFunc)(uint8_t* row,
+                                size_t width,
+                                const float* color,
+                                const float* step);
+
+struct RowKernels
+{
+    FillRowFunc fill;
+    FillRowFunc blend;
+    BlitRowFunc blit;
+    BlitRowFunc blitSwap;
+    GradientRowFunc gradient;
+};
+
+/*****************************************************************************/
+uint32_t divide255(uint32_t value)
+{
+    value += 128;
+    return (value + (value >> 8)) >> 8;
+}
+
+/*****************************************************************************/
+void blendPixel(const uint8_t* source, uint8_t* destination)
+{
+    const uint32_t alpha = source[ALPHA];
+    if (alpha == 255)
+    {
+        memcpy(destination, source, 4);
+        return;
+    }
+    if (alpha == 0)
+    {
+        return;
+    }
+
+    const uint32_t inverse = 255 - alpha;
+    for (size_t ii = 0; ii < ALPHA; ++ii)
+    {
+        destination[ii] = static_cast<uint8_t>(
+                divide255(source[ii] * alpha + destination[ii] * inverse));
+    }
+    destination[ALPHA] = static_cast<uint8_t>(
+            divide255(255 * alpha + destination[ALPHA] * inverse));
+}
+
+/*****************************************************************************/
+void fillRowScalar(uint8_t* row, size_t width, const uint8_t* color)
+{
+    for (size_t ii = 0; ii < width; ++ii)
+    {
+        memcpy(row + ii * 4, color, 4);
+    }
+}
+
+/*****************************************************************************/
+void blendRowScalar(uint8_t* row, size_t width, const uint8_t* color)
+{
+    for (size_t ii = 0; ii < width; ++ii)
+    {
+        blendPixel(color, row + ii * 4);
+    }
+}
+
+/*****************************************************************************/
+template <bool SwapT>
+void blitRowScalar(const uint8_t* source, uint8_t* destination, size_t width)
+{
+    for (size_t ii = 0; ii < width; ++ii)
+    {
+        uint8_t pixel[4];
+        memcpy(pixel, source + ii * 4, 4);
+        if (SwapT)
+        {
+            std::swap(pixel[0], pixel[2]);
+        }
+        blendPixel(pixel, destination + ii * 4);
+    }
+}
+
+/*****************************************************************************/
+void gradientRowScalar(uint8_t* row,
+                       size_t width,
+                       const float* color,
+                       const float* step)
+{
+    // color already has 0.5 added so truncating rounds to nearest.
+    float value[4] = {color[0], color[1], color[2], color[3]};
+    for (size_t ii = 0; ii < width; ++ii)
+    {
+        uint8_t pixel[4];
+        for (size_t channel = 0; channel < 4; ++channel)
+        {
+            pixel[channel] = static_cast<uint8_t>(
+                    std::min(std::max(value[channel], 0.0f), 255.0f));
+            value[channel] += step[channel];
+        }
+        blendPixel(pixel, row + ii * 4);
+    }
+}
+
+#ifdef NYRA_X86
+/*****************************************************************************/
+NYRA_TARGET("sse2")
+inline __m128i divide255SSE2(__m128i value)
+{
+    value = _mm_add_epi16(value, _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(value, _mm_srli_epi16(value, 8)), 8);
+}
+
+/*****************************************************************************/
+NYRA_TARGET("sse2")
+inline __m128i blendPixelsSSE2(__m128i source, __m128i destination)
+{
+    // Spread each pixel's alpha over its four 16 bit channels. The alpha
+    // channel itself blends 255 over the destination alpha.
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i max = _mm_set1_epi16(255);
+    const __m128i alpha = _mm_srli_epi32(source, 24);
+    const __m128i alpha16 = _mm_or_si128(alpha, _mm_slli_epi32(alpha, 16));
+    const __m128i alphaLow = _mm_unpacklo_epi32(alpha16, alpha16);
+    const __m128i alphaHigh = _mm_unpackhi_epi32(alpha16, alpha16);
+    const __m128i opaque = _mm_or_si128(
+            source, _mm_set1_epi32(static_cast<int>(0xFF000000)));
+
+    const __m128i low = _mm_add_epi16(
+            _mm_mullo_epi16(_mm_unpacklo_epi8(opaque, zero), alphaLow),
+            _mm_mullo_epi16(_mm_unpacklo_epi8(destination, zero),
+                            _mm_sub_epi16(max, alphaLow)));
+    const __m128i high = _mm_add_epi16(
+            _mm_mullo_epi16(_mm_unpackhi_epi8(opaque, zero), alphaHigh),
+            _mm_mullo_epi16(_mm_unpackhi_epi8(destination, zero),
+                            _mm_sub_epi16(max, alphaHigh)));
+    return _mm_packus_epi16(divide255SSE2(low), divide255SSE2(high));
+}
+
+/*****************************************************************************/
+NYRA_TARGET("sse2")
+void fillRowSSE2(uint8_t* row, size_t width, const uint8_t* color)
+{
+    int32_t packed;
+    memcpy(&packed, color, 4);
+    const __m128i pixels = _mm_set1_epi32(packed);
+    size_t ii = 0;
+    for (; ii + 4 <= width; ii += 4)
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(row + ii * 4), pixels);
+    }
+    fillRowScalar(row + ii * 4, width - ii, color);
+}
+
+/*****************************************************************************/
+NYRA_TARGET("sse2")
+void blendRowSSE2(uint8_t* row, size_t width, const uint8_t* color)
+{
+    int32_t packed;
+    memcpy(&packed, color, 4);
+    const __m128i source = _mm_set1_epi32(packed);
+    size_t ii = 0;
+    for (; ii + 4 <= width; ii += 4)
+    {
+        __m128i* out = reinterpret_cast<__m128i*>(row + ii * 4);
+        _mm_storeu_si128(out,
+                         blendPixelsSSE2(source, _mm_loadu_si128(out)));
+    }
+    blendRowScalar(row + ii * 4, width - ii, color);
+}
+
+/*****************************************************************************/
+template <bool SwapT>
+NYRA_TARGET("sse2")
+void blitRowSSE2(const uint8_t* source, uint8_t* destination, size_t width)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i alphaMask = _mm_set1_epi32(static_cast<int>(0xFF000000));
+    const __m128i greenAlpha = _mm_set1_epi32(static_cast<int>(0xFF00FF00));
+    const __m128i low = _mm_set1_epi32(0xFF);
+    size_t ii = 0;
+    for (; ii + 4 <= width; ii += 4)
+    {
+        __m128i pixels = _mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(source + ii * 4));
+        if (SwapT)
+        {
+            const __m128i first = _mm_and_si128(pixels, low);
+            const __m128i third = _mm_and_si128(_mm_srli_epi32(pixels, 16),
+                                                low);
+            pixels = _mm_or_si128(
+                    _mm_and_si128(pixels, greenAlpha),
+                    _mm_or_si128(_mm_slli_epi32(first, 16), third));
+        }
+
+        // Sprites are mostly fully opaque or fully clear, so skip the
+        // blend when all four pixels are one or the other.
+        __m128i* out = reinterpret_cast<__m128i*>(destination + ii * 4);
+        const __m128i alpha = _mm_and_si128(pixels, alphaMask);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(alpha, alphaMask)) == 0xFFFF)
+        {
+            _mm_storeu_si128(out, pixels);
+        }
+        else if (_mm_movemask_epi8(_mm_cmpeq_epi32(alpha, zero)) != 0xFFFF)
+        {
+            _mm_storeu_si128(out,
+                             blendPixelsSSE2(pixels, _mm_loadu_si128(out)));
+        }
+    }
+    blitRowScalar<SwapT>(source + ii * 4, destination + ii * 4, width - ii);
+}
+
+/*****************************************************************************/
+NYRA_TARGET("sse2")
+void gradientRowSSE2(uint8_t* row,
+                     size_t width,
+                     const float* color,
+                     const float* step)
+{
+    const __m128i alphaMask = _mm_set1_epi32(static_cast<int>(0xFF000000));
+    const __m128 delta = _mm_loadu_ps(step);
+    const __m128 delta4 = _mm_mul_ps(delta, _mm_set1_ps(4.0f));
+    __m128 value = _mm_loadu_ps(color);
+    size_t ii = 0;
+    for (; ii + 4 <= width; ii += 4)
+    {
+        // Saturating packs clamp each channel to 0 through 255.
+        const __m128 value1 = _mm_add_ps(value, delta);
+        const __m128 value2 = _mm_add_ps(value1, delta);
+        const __m128 value3 = _mm_add_ps(value2, delta);
+        const __m128i pixels = _mm_packus_epi16(
+                _mm_packs_epi32(_mm_cvttps_epi32(value),
+                                _mm_cvttps_epi32(value1)),
+                _mm_packs_epi32(_mm_cvttps_epi32(value2),
+                                _mm_cvttps_epi32(value3)));
+        value = _mm_add_ps(value, delta4);
+
+        __m128i* out = reinterpret_cast<__m128i*>(row + ii * 4);
+        const __m128i alpha = _mm_and_si128(pixels, alphaMask);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(alpha, alphaMask)) == 0xFFFF)
+        {
+            _mm_storeu_si128(out, pixels);
+        }
+        else
+        {
+            _mm_storeu_si128(out,
+                             blendPixelsSSE2(pixels, _mm_loadu_si128(out)));
+        }
+    }
+
+    float rest[4];
+    _mm_storeu_ps(rest, value);
+    gradientRowScalar(row + ii * 4, width - ii, rest, step);
+}
+#endif
+
+/*****************************************************************************/
+RowKernels getRowKernels()
+{
+#ifdef NYRA_X86
+    static const bool sse2 = nyra::core::hasSSE2();
+    if (sse2)
+    {
+        const RowKernels kernels =
+        {
+            fillRowSSE2,
+            blendRowSSE2,
+            blitRowSSE2<false>,
+            blitRowSSE2<true>,
+            gradientRowSSE2
+        };
+        return kernels;
+    }
+#endif
+
+    const RowKernels kernels =
+    {
+        fillRowScalar,
+        blendRowScalar,
+        blitRowScalar<false>,
+        blitRowScalar<true>,
+        gradientRowScalar
+    };
+    return kernels;
+}
+
+/*****************************************************************************/
+float clampCoordinate(float value)
+{
+    return std::min(std::max(value, -COORDINATE_LIMIT), COORDINATE_LIMIT);
+}
+
+/*****************************************************************************/
+double getEdge(const nyra::core::Vector2F& start,
+               const nyra::core::Vector2F& end,
+               double x,
+               double y)
+{
+    // With floats stored in doubles this is exact for any coordinates the
+    // target can hold, so neighboring triangles agree on shared edges.
+    return (static_cast<double>(end.x()) - start.x()) * (y - start.y()) -
+           (static_cast<double>(end.y()) - start.y()) * (x - start.x());
+}
+
+/*****************************************************************************/
+bool isInside(double edge, bool topLeft)
+{
+    return edge > 0.0 || (edge == 0.0 && topLeft);
+}
+
+/*****************************************************************************/
+bool isTopLeft(const nyra::core::Vector2F& start,
+               const nyra::core::Vector2F& end)
+{
+    return (start.y() == end.y() && end.x() > start.x()) ||
+           end.y() < start.y();
+}
+}
+
+namespace nyra
+{
+namespace graphics
+{
+/*****************************************************************************/
+Rasterizer::Rasterizer(void* pixels,
+                       const core::Vector2UI& size,
+                       PixelFormat format,
+                       size_t pitch) :
+    mPixels(static_cast<uint8_t*>(pixels)),
+    mSize(size),
+    mFormat(format),
+    mPitch(pitch ? pitch : size.x() * 4),
+    mBounds(0,
+            0,
+            static_cast<int32_t>(size.x()),
+            static_cast<int32_t>(size.y())),
+    mTileColumns((mBounds.width + TILE_WIDTH - 1) / TILE_WIDTH),
+    mTileRows((mBounds.height + TILE_HEIGHT - 1) / TILE_HEIGHT)
+{
+    if (format != RGBA8 && format != BGRA8)
+    {
+        throw core::Exception("Rasterizer only draws into RGBA8 or BGRA8");
+    }
+    mBins.resize(mTileColumns * mTileRows);
+}
+
+/*****************************************************************************/
+void Rasterizer::clear(const Color& color)
+{
+    mCommands.clear();
+    for (size_t ii = 0; ii < mBins.size(); ++ii)
+    {
+        mBins[ii].clear();
+    }
+
+    Command command = Command();
+    command.type = CLEAR;
+    command.bounds = mBounds;
+    toTarget(color, command.colors[0]);
+    push(command);
+}
+
+/*****************************************************************************/
+void Rasterizer::fillRect(const Rect& rect, const Color& color)
+{
+    if (color.alpha == 0)
+    {
+        return;
+    }
+
+    Command command = Command();
+    command.type = FILL;
+    command.bounds = rect;
+    toTarget(color, command.colors[0]);
+    push(command);
+}
+
+/*****************************************************************************/
+void Rasterizer::drawRect(const Rect& rect, const Color& color)
+{
+    if (rect.isEmpty())
+    {
+        return;
+    }
+
+    // The sides do not overlap so translucent outlines blend evenly.
+    fillRect(Rect(rect.x, rect.y, rect.width, 1), color);
+    if (rect.height > 1)
+    {
+        fillRect(Rect(rect.x, rect.getBottom() - 1, rect.width, 1), color);
+    }
+    if (rect.height > 2)
+    {
+        fillRect(Rect(rect.x, rect.y + 1, 1, rect.height - 2), color);
+        if (rect.width > 1)
+        {
+            fillRect(Rect(rect.getRight() - 1,
+                          rect.y + 1,
+                          1,
+                          rect.height - 2),
+                     color);
+        }
+    }
+}
+
+/*****************************************************************************/
+void Rasterizer::drawLine(const core::Vector2F& start,
+                          const core::Vector2F& end,
+                          const Color& color)
+{
+    if (color.alpha == 0)
+    {
+        return;
+    }
+
+    Command command = Command();
+    command.type = LINE;
+    command.points[0] = core::Vector2F(std::floor(clampCoordinate(start.x())),
+                                       std::floor(clampCoordinate(start.y())));
+    command.points[1] = core::Vector2F(std::floor(clampCoordinate(end.x())),
+                                       std::floor(clampCoordinate(end.y())));
+    if (std::isnan(command.points[0].x()) ||
+        std::isnan(command.points[0].y()) ||
+        std::isnan(command.points[1].x()) ||
+        std::isnan(command.points[1].y()))
+    {
+        return;
+    }
+
+    const int32_t left = static_cast<int32_t>(
+            std::min(command.points[0].x(), command.points[1].x()));
+    const int32_t top = static_cast<int32_t>(
+            std::min(command.points[0].y(), command.points[1].y()));
+    const int32_t right = static_cast<int32_t>(
+            std::max(command.points[0].x(), command.points[1].x()));
+    const int32_t bottom = static_cast<int32_t>(
+            std::max(command.points[0].y(), command.points[1].y()));
+    command.bounds = Rect(left, top, right - left + 1, bottom - top + 1);
+    toTarget(color, command.colors[0]);
+    push(command);
+}
+
+/*****************************************************************************/
+void Rasterizer::fillTriangle(const core::Vector2F& first,
+                              const core::Vector2F& second,
+                              const core::Vector2F& third,
+                              const Color& color)
+{
+    fillTriangle(first, second, third, color, color, color);
+}
+
+/*****************************************************************************/
+void Rasterizer::fillTriangle(const core::Vector2F& first,
+                              const core::Vector2F& second,
+                              const core::Vector2F& third,
+                              const Color& firstColor,
+                              const Color& secondColor,
+                              const Color& thirdColor)
+{
+    if (firstColor.alpha == 0 && secondColor.alpha == 0 &&
+        thirdColor.alpha == 0)
+    {
+        return;
+    }
+
+    Command command = Command();
+    command.type = TRIANGLE;
+    const core::Vector2F* corners[3] = {&first, &second, &third};
+    for (size_t ii = 0; ii < 3; ++ii)
+    {
+        command.points[ii] = core::Vector2F(
+                clampCoordinate(corners[ii]->x()),
+                clampCoordinate(corners[ii]->y()));
+    }
+    toTarget(firstColor, command.colors[0]);
+    toTarget(secondColor, command.colors[1]);
+    toTarget(thirdColor, command.colors[2]);
+
+    // Wind every triangle the same way so the inside is always where the
+    // edge functions are positive. This also skips NaN corners.
+    const double area = getEdge(command.points[0],
+                                command.points[1],
+                                command.points[2].x(),
+                                command.points[2].y());
+    if (!(area > 0.0 || area < 0.0))
+    {
+        return;
+    }
+    if (area < 0.0)
+    {
+        std::swap(command.points[1], command.points[2]);
+        std::swap(command.colors[1], command.colors[2]);
+    }
+
+    const float left = std::min(std::min(command.points[0].x(),
+                                         command.points[1].x()),
+                                command.points[2].x());
+    const float top = std::min(std::min(command.points[0].y(),
+                                        command.points[1].y()),
+                               command.points[2].y());
+    const float right = std::max(std::max(command.points[0].x(),
+                                          command.points[1].x()),
+                                 command.points[2].x());
+    const float bottom = std::max(std::max(command.points[0].y(),
+                                           command.points[1].y()),
+                                  command.points[2].y());
+    const int32_t x = static_cast<int32_t>(std::floor(left));
+    const int32_t y = static_cast<int32_t>(std::floor(top));
+    command.bounds = Rect(x,
+                          y,
+                          static_cast<int32_t>(std::ceil(right)) - x,
+                          static_cast<int32_t>(std::ceil(bottom)) - y);
+    push(command);
+}
+
+/*****************************************************************************/
+void Rasterizer::blit(const PixelBuffer& image,
+                      const core::Vector2I& position)
+{
+    blit(image,
+         Rect(0,
+              0,
+              static_cast<int32_t>(image.size.x()),
+              static_cast<int32_t>(image.size.y())),
+         position);
+}
+
+/*****************************************************************************/
+void Rasterizer::blit(const PixelBuffer& image,
+                      const Rect& source,
+                      const core::Vector2I& position)
+{
+    if (image.format != RGBA8 && image.format != BGRA8)
+    {
+        throw core::Exception("Rasterizer can only blit RGBA8 or BGRA8");
+    }
+
+    const Rect clipped = source.intersect(
+            Rect(0,
+                 0,
+                 static_cast<int32_t>(image.size.x()),
+                 static_cast<int32_t>(image.size.y())));
+    if (clipped.isEmpty())
+    {
+        return;
+    }
+
+    Command command = Command();
+    command.type = BLIT;
+    command.origin = core::Vector2I(position.x() - source.x,
+                                    position.y() - source.y);
+    command.bounds = Rect(static_cast<int32_t>(command.origin.x()) +
+                                  clipped.x,
+                          static_cast<int32_t>(command.origin.y()) +
+                                  clipped.y,
+                          clipped.width,
+                          clipped.height);
+    command.image = static_cast<const uint8_t*>(image.pixels);
+    command.imagePitch = image.pitch;
+    command.swapRedBlue = image.format != mFormat;
+    push(command);
+}
+
+/*****************************************************************************/
+void Rasterizer::blit(const TextureAtlas& atlas,
+                      TextureAtlas::Handle handle,
+                      const core::Vector2I& position)
+{
+    const TextureAtlas::Region& region = atlas.getRegion(handle);
+    if (region.rect.isEmpty())
+    {
+        return;
+    }
+
+    Command command = Command();
+    command.type = ATLAS_BLIT;
+    command.origin = core::Vector2I(position.x() - region.rect.x,
+                                    position.y() - region.rect.y);
+    command.bounds = Rect(static_cast<int32_t>(position.x()),
+                          static_cast<int32_t>(position.y()),
+                          region.rect.width,
+                          region.rect.height);
+    command.swapRedBlue = atlas.getFormat() != mFormat;
+    command.atlas = &atlas;
+    command.page = region.page;
+    push(command);
+}
+
+/*****************************************************************************/
+void Rasterizer::flush(core::ThreadPool* pool)
+{
+    const auto drawTiles = [this](size_t begin, size_t end)
+    {
+        for (size_t ii = begin; ii < end; ++ii)
+        {
+            if (mBins[ii].empty())
+            {
+                continue;
+            }
+
+            const int32_t x = static_cast<int32_t>(ii % mTileColumns);
+            const int32_t y = static_cast<int32_t>(ii / mTileColumns);
+            drawTile(Rect(x * TILE_WIDTH,
+                          y * TILE_HEIGHT,
+                          TILE_WIDTH,
+                          TILE_HEIGHT).intersect(mBounds),
+                     mBins[ii]);
+        }
+    };
+
+    if (pool)
+    {
+        pool->parallelFor(mBins.size(), 4, drawTiles);
+    }
+    else
+    {
+        drawTiles(0, mBins.size());
+    }
+
+    mCommands.clear();
+    for (size_t ii = 0; ii < mBins.size(); ++ii)
+    {
+        mBins[ii].clear();
+    }
+}
+
+/*****************************************************************************/
+void Rasterizer::toTarget(const Color& color, uint8_t* bytes) const
+{
+    bytes[0] = mFormat == RGBA8 ? color.red : color.blue;
+    bytes[1] = color.green;
+    bytes[2] = mFormat == RGBA8 ? color.blue : color.red;
+    bytes[ALPHA] = color.alpha;
+}
+
+/*****************************************************************************/
+void Rasterizer::push(const Command& command)
+{
+    const Rect bounds = command.bounds.intersect(mBounds);
+    if (bounds.isEmpty())
+    {
+        return;
+    }
+
+    const uint32_t index = static_cast<uint32_t>(mCommands.size());
+    mCommands.push_back(command);
+    mCommands.back().bounds = bounds;
+
+    // Each tile gets the commands that touch it, in order.
+    const int32_t lastX = (bounds.getRight() - 1) / TILE_WIDTH;
+    const int32_t lastY = (bounds.getBottom() - 1) / TILE_HEIGHT;
+    for (int32_t y = bounds.y / TILE_HEIGHT; y <= lastY; ++y)
+    {
+        for (int32_t x = bounds.x / TILE_WIDTH; x <= lastX; ++x)
+        {
+            mBins[y * mTileColumns + x].push_back(index);
+        }
+    }
+}
+
+/*****************************************************************************/
+void Rasterizer::drawTile(const Rect& tile, const std::vector<uint32_t>& bin)
+{
+    const RowKernels kernels = getRowKernels();
+    for (size_t ii = 0; ii < bin.size(); ++ii)
+    {
+        const Command& command = mCommands[bin[ii]];
+        const Rect area = command.bounds.intersect(tile);
+        if (area.isEmpty())
+        {
+            continue;
+        }
+
+        switch (command.type)
+        {
+        case CLEAR:
+        case FILL:
+        {
+            const FillRowFunc fill =
+                    command.type == CLEAR || command.colors[0][ALPHA] == 255 ?
+                            kernels.fill : kernels.blend;
+            for (int32_t y = area.y; y < area.getBottom(); ++y)
+            {
+                fill(getPixel(area.x, y), area.width, command.colors[0]);
+            }
+            break;
+        }
+        case LINE:
+            drawLine(command, area);
+            break;
+        case TRIANGLE:
+            drawTriangle(command, area);
+            break;
+        case BLIT:
+            drawBlit(command, area);
+            break;
+        case ATLAS_BLIT:
+            drawAtlasBlit(command, area);
+            break;
+        }
+    }
+}
+
+/*****************************************************************************/
+void Rasterizer::drawLine(const Command& command, const Rect& area)
+{
+    // Every pixel is found from its step along the longer axis alone, so
+    // tiles agree on the pixels where the line crosses between them.
+    const double startX = command.points[0].x();
+    const double startY = command.points[0].y();
+    const double deltaX = command.points[1].x() - startX;
+    const double deltaY = command.points[1].y() - startY;
+    const bool alongX = std::fabs(deltaX) >= std::fabs(deltaY);
+    const double steps = std::max(std::fabs(deltaX), std::fabs(deltaY));
+
+    const double major = alongX ? startX : startY;
+    const double minor = alongX ? startY : startX;
+    const double direction = (alongX ? deltaX : deltaY) < 0.0 ? -1.0 : 1.0;
+    const double slope = steps > 0.0 ? (alongX ? deltaY : deltaX) / steps :
+                                       0.0;
+    const double areaStart = alongX ? area.x : area.y;
+    const double areaEnd = (alongX ? area.getRight() : area.getBottom()) - 1;
+
+    const double first = std::max(0.0, direction > 0.0 ?
+            areaStart - major : major - areaEnd);
+    const double last = std::min(steps, direction > 0.0 ?
+            areaEnd - major : major - areaStart);
+    for (double step = first; step <= last; step += 1.0)
+    {
+        const int32_t a = static_cast<int32_t>(major + direction * step);
+        const int32_t b = static_cast<int32_t>(
+                std::floor(minor + slope * step + 0.5));
+        const int32_t x = alongX ? a : b;
+        const int32_t y = alongX ? b : a;
+        if (x >= area.x && x < area.getRight() &&
+            y >= area.y && y < area.getBottom())
+        {
+            blendPixel(command.colors[0], getPixel(x, y));
+        }
+    }
+}
+
+/*****************************************************************************/
+void Rasterizer::drawTriangle(const Command& command, const Rect& area)
+{
+    const core::Vector2F* points = command.points;
+    const double total = getEdge(points[0], points[1],
+                                 points[2].x(), points[2].y());
+
+    // Edge ii is opposite corner ii, so its value over the total area is
+    // the weight of that corner's color.
+    const core::Vector2F* starts[3] = {&points[1], &points[2], &points[0]};
+    const core::Vector2F* ends[3] = {&points[2], &points[0], &points[1]};
+    double stepX[3];
+    double stepY[3];
+    bool topLeft[3];
+    for (size_t ii = 0; ii < 3; ++ii)
+    {
+        stepX[ii] = static_cast<double>(starts[ii]->y()) - ends[ii]->y();
+        stepY[ii] = static_cast<double>(ends[ii]->x()) - starts[ii]->x();
+        topLeft[ii] = isTopLeft(*starts[ii], *ends[ii]);
+    }
+
+    const bool flat =
+            memcmp(command.colors[0], command.colors[1], 4) == 0 &&
+            memcmp(command.colors[0], command.colors[2], 4) == 0;
+    const RowKernels kernels = getRowKernels();
+    const FillRowFunc fill = command.colors[0][ALPHA] == 255 ?
+            kernels.fill : kernels.blend;
+
+    const double inverseTotal = 1.0 / total;
+    float colorStep[4];
+    for (size_t channel = 0; channel < 4; ++channel)
+    {
+        double step = 0.0;
+        for (size_t ii = 0; ii < 3; ++ii)
+        {
+            step += stepX[ii] * inverseTotal * command.colors[ii][channel];
+        }
+        colorStep[channel] = static_cast<float>(step);
+    }
+
+    // Edge values only change by whole steps from the first pixel, which
+    // stays exact, so every pixel matches evaluating the edges directly.
+    double firstRow[3];
+    for (size_t ii = 0; ii < 3; ++ii)
+    {
+        firstRow[ii] = getEdge(*starts[ii],
+                               *ends[ii],
+                               area.x + 0.5,
+                               area.y + 0.5);
+    }
+
+    for (int32_t y = area.y; y < area.getBottom(); ++y)
+    {
+        double edges[3];
+        for (size_t ii = 0; ii < 3; ++ii)
+        {
+            edges[ii] = firstRow[ii] + stepY[ii] * (y - area.y);
+        }
+
+        // The inside of a triangle is one run of pixels on each row. Each
+        // edge bounds it on one side, found by solving for where the edge
+        // crosses zero and then nudged so ties follow the fill rule.
+        int32_t begin = 0;
+        int32_t end = area.width;
+        for (size_t ii = 0; ii < 3 && begin < end; ++ii)
+        {
+            if (stepX[ii] == 0.0)
+            {
+                if (!isInside(edges[ii], topLeft[ii]))
+                {
+                    end = begin;
+                }
+                continue;
+            }
+
+            const double crossing = std::min(
+                    std::max(-edges[ii] / stepX[ii], -1.0),
+                    static_cast<double>(area.width) + 1.0);
+            if (stepX[ii] > 0.0)
+            {
+                int32_t first = static_cast<int32_t>(std::ceil(crossing));
+                while (first > 0 &&
+                       isInside(edges[ii] + stepX[ii] * (first - 1),
+                                topLeft[ii]))
+                {
+                    --first;
+                }
+                while (first < area.width &&
+                       !isInside(edges[ii] + stepX[ii] * first, topLeft[ii]))
+                {
+                    ++first;
+                }
+                begin = std::max(begin, first);
+            }
+            else
+            {
+                int32_t last = static_cast<int32_t>(std::floor(crossing));
+                while (last < area.width - 1 &&
+                       isInside(edges[ii] + stepX[ii] * (last + 1),
+                                topLeft[ii]))
+                {
+                    ++last;
+                }
+                while (last >= 0 &&
+                       !isInside(edges[ii] + stepX[ii] * last, topLeft[ii]))
+                {
+                    --last;
+                }
+                end = std::min(end, last + 1);
+            }
+        }
+
+        if (begin >= end)
+        {
+            continue;
+        }
+
+        if (flat)
+        {
+            fill(getPixel(area.x + begin, y), end - begin, command.colors[0]);
+            continue;
+        }
+
+        // Colors change by a fixed amount per pixel along the row, so
+        // only the first pixel needs the corner weights.
+        double weights[3];
+        for (size_t ii = 0; ii < 3; ++ii)
+        {
+            weights[ii] = (edges[ii] + stepX[ii] * begin) * inverseTotal;
+        }
+
+        float color[4];
+        for (size_t channel = 0; channel < 4; ++channel)
+        {
+            color[channel] = static_cast<float>(
+                    0.5 + weights[0] * command.colors[0][channel] +
+                    weights[1] * command.colors[1][channel] +
+                    weights[2] * command.colors[2][channel]);
+        }
+
+        kernels.gradient(getPixel(area.x + begin, y),
+                         end - begin,
+                         color,
+                         colorStep);
+    }
+}
+
+/*****************************************************************************/
+void Rasterizer::drawBlit(const Command& command, const Rect& area)
+{
+    const RowKernels kernels = getRowKernels();
+    const BlitRowFunc blitRow = command.swapRedBlue ? kernels.blitSwap :
+                                                      kernels.blit;
+    const size_t column = area.x - static_cast<int32_t>(command.origin.x());
+    for (int32_t y = area.y; y < area.getBottom(); ++y)
+    {
+        const size_t row = y - static_cast<int32_t>(command.origin.y());
+        blitRow(command.image + row * command.imagePitch + column * 4,
+                getPixel(area.x, y),
+                area.width);
+    }
+}
+
+/*****************************************************************************/
+void Rasterizer::drawAtlasBlit(const Command& command, const Rect& area)
+{
+    // Each row of a tile is contiguous, so the image is drawn in strips
+    // that stop at tile edges. Down a strip the source only moves to
+    // another tile every TILE_SIZE rows.
+    const RowKernels kernels = getRowKernels();
+    const BlitRowFunc blitRow = command.swapRedBlue ? kernels.blitSwap :
+                                                      kernels.blit;
+    const size_t tileSize = TextureAtlas::TILE_SIZE;
+    const size_t column = area.x - static_cast<int32_t>(command.origin.x());
+    const size_t firstRow = area.y - static_cast<int32_t>(command.origin.y());
+    size_t x = 0;
+    while (x < static_cast<size_t>(area.width))
+    {
+        const size_t source = column + x;
+        const size_t run = std::min(tileSize - source % tileSize,
+                                    area.width - x);
+        const uint8_t* in = command.atlas->getPixel(command.page,
+                                                    source,
+                                                    firstRow);
+        uint8_t* out = getPixel(area.x + static_cast<int32_t>(x), area.y);
+        for (size_t row = firstRow; row < firstRow + area.height; ++row)
+        {
+            blitRow(in, out, run);
+            out += mPitch;
+            in = (row + 1) % tileSize ?
+                    in + tileSize * 4 :
+                    command.atlas->getPixel(command.page, source, row + 1);
+        }
+        x += run;
+    }
+}
+}
+}
@@ -0,0 +1,299 @@
+/******************************************************************************
+ * The MIT License(MIT)
+ *
+ * Copyright(c) 2015 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+#include <string.h>
+#include <algorithm>
+#include <utility>
+#include <graphics/TextureAtlas.h>
+#include <graphics/Image.h>
+#include <core/Exception.h>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+namespace nyra
+{
+namespace graphics
+{
+/*****************************************************************************/
+TextureAtlas::TextureAtlas(const core::Vector2UI& pageSize,
+                           PixelFormat format) :
+    mPageSize((pageSize.x() + TILE_SIZE - 1) / TILE_SIZE * TILE_SIZE,
+              (pageSize.y() + TILE_SIZE - 1) / TILE_SIZE * TILE_SIZE),
+    mFormat(format),
+    mTileColumns(mPageSize.x() / TILE_SIZE)
+{
+    if (format != RGBA8 && format != BGRA8)
+    {
+        throw core::Exception("TextureAtlas pages must be RGBA8 or BGRA8");
+    }
+}
+
+/*****************************************************************************/
+TextureAtlas::Handle TextureAtlas::add(const PixelBuffer& image)
+{
+    const int32_t width = static_cast<int32_t>(image.size.x());
+    const int32_t height = static_cast<int32_t>(image.size.y());
+    if (image.size.x() > mPageSize.x() || image.size.y() > mPageSize.y())
+    {
+        throw core::Exception("Image is bigger than a texture atlas page");
+    }
+
+    Region region = Region();
+    if (width > 0 && height > 0)
+    {
+        // Use the existing page that fits the image lowest, or start a new
+        // page if none has room.
+        size_t bestPage = mPages.size();
+        int32_t bestX = 0;
+        int32_t bestY = 0;
+        for (size_t ii = 0; ii < mPages.size(); ++ii)
+        {
+            int32_t x;
+            int32_t y;
+            if (findPosition(mPages[ii], width, height, x, y) &&
+                (bestPage == mPages.size() || y < bestY))
+            {
+                bestPage = ii;
+                bestX = x;
+                bestY = y;
+            }
+        }
+
+        if (bestPage == mPages.size())
+        {
+            Page page;
+            const size_t bytes = mPageSize.x() * mPageSize.y() * 4;
+            page.pixels.reserve(bytes);
+#ifdef __linux__
+            // Asked for before the pixels are first written, since that is
+            // when the memory is mapped. This is only a hint so failures
+            // are not fatal.
+            madvise(page.pixels.data(), bytes, MADV_HUGEPAGE);
+#endif
+            page.pixels.resize(bytes);
+            Segment segment = {0, 0, static_cast<int32_t>(mPageSize.x())};
+            page.skyline.push_back(segment);
+            mPages.push_back(std::move(page));
+            findPosition(mPages.back(), width, height, bestX, bestY);
+        }
+
+        Page& page = mPages[bestPage];
+        region.page = bestPage;
+        region.rect = Rect(bestX, bestY, width, height);
+        addSegment(page, bestX, width, height, bestY);
+
+        // Convert a row at a time, then split it across the tiles it
+        // lands in.
+        std::vector<uint8_t> row(width * 4);
+        const uint8_t* in = static_cast<const uint8_t*>(image.pixels);
+        for (int32_t y = 0; y < height; ++y)
+        {
+            convertPixels(PixelBuffer(in + y * image.pitch,
+                                      core::Vector2UI(width, 1),
+                                      image.format,
+                                      image.pitch),
+                          &row[0],
+                          row.size(),
+                          mFormat);
+
+            const size_t pageY = region.rect.y + y;
+            int32_t x = 0;
+            while (x < width)
+            {
+                const size_t pageX = region.rect.x + x;
+                const int32_t run = std::min<int32_t>(
+                        TILE_SIZE - pageX % TILE_SIZE, width - x);
+                memcpy(&page.pixels[getOffset(pageX, pageY)],
+                       &row[x * 4],
+                       run * 4);
+                x += run;
+            }
+        }
+    }
+
+    region.left = static_cast<float>(region.rect.x) / mPageSize.x();
+    region.top = static_cast<float>(region.rect.y) / mPageSize.y();
+    region.right = static_cast<float>(region.rect.getRight()) /
+                   mPageSize.x();
+    region.bottom = static_cast<float>(region.rect.getBottom()) /
+                    mPageSize.y();
+    mRegions.push_back(region);
+    return static_cast<Handle>(mRegions.size() - 1);
+}
+
+/*****************************************************************************/
+TextureAtlas::Handle TextureAtlas::add(const std::string& pathname)
+{
+    return add(readTGA(pathname).getBuffer());
+}
+
+/*****************************************************************************/
+void TextureAtlas::copyRegion(Handle handle,
+                              void* destination,
+                              size_t pitch) const
+{
+    const Region& region = mRegions[handle];
+    if (!pitch)
+    {
+        pitch = region.rect.width * 4;
+    }
+
+    uint8_t* out = static_cast<uint8_t*>(destination);
+    for (int32_t y = 0; y < region.rect.height; ++y)
+    {
+        int32_t x = 0;
+        while (x < region.rect.width)
+        {
+            const size_t pageX = region.rect.x + x;
+            const int32_t run = std::min<int32_t>(
+                    TILE_SIZE - pageX % TILE_SIZE, region.rect.width - x);
+            memcpy(out + y * pitch + x * 4,
+                   getPixel(region.page, pageX, region.rect.y + y),
+                   run * 4);
+            x += run;
+        }
+    }
+}
+
+/*****************************************************************************/
+bool TextureAtlas::findPosition(const Page& page,
+                                int32_t width,
+                                int32_t height,
+                                int32_t& x,
+                                int32_t& y) const
+{
+    // Bottom left: the image sits on the highest segment under it, and
+    // the spot that leaves its top edge lowest wins. Images start on a
+    // multiple of ALIGNMENT so the runs a blit splits a row into at tile
+    // edges stay whole steps of the row kernels, and an image that fits
+    // in a tile is kept inside one so each of its rows is a single run.
+    const int32_t tileSize = static_cast<int32_t>(TILE_SIZE);
+    const int32_t pageWidth = static_cast<int32_t>(mPageSize.x());
+    bool found = false;
+    int32_t bestTop = 0;
+    for (size_t ii = 0; ii < page.skyline.size(); ++ii)
+    {
+        int32_t left = (page.skyline[ii].x + ALIGNMENT - 1) /
+                       ALIGNMENT * ALIGNMENT;
+        if (width <= tileSize && left % tileSize + width > tileSize)
+        {
+            left = (left / tileSize + 1) * tileSize;
+        }
+
+        if (left + width > pageWidth)
+        {
+            break;
+        }
+
+        size_t first = ii;
+        while (page.skyline[first].x + page.skyline[first].width <= left)
+        {
+            ++first;
+        }
+
+        int32_t base = 0;
+        for (size_t jj = first;
+             jj < page.skyline.size() && page.skyline[jj].x < left + width;
+             ++jj)
+        {
+            base = std::max(base, page.skyline[jj].y);
+        }
+
+        const int32_t top = base + height;
+        if (top <= static_cast<int32_t>(mPageSize.y()) &&
+            (!found || top < bestTop))
+        {
+            found = true;
+            bestTop = top;
+            x = left;
+            y = base;
+        }
+    }
+    return found;
+}
+
+/*****************************************************************************/
+void TextureAtlas::addSegment(Page& page,
+                              int32_t x,
+                              int32_t width,
+                              int32_t height,
+                              int32_t y)
+{
+    std::vector<Segment>& skyline = page.skyline;
+    const Segment added = {x, y + height, width};
+    const int32_t right = added.x + added.width;
+
+    // Split the segment the image starts over when the image starts
+    // partway along it. The piece to its left keeps its height.
+    size_t index = 0;
+    while (skyline[index].x + skyline[index].width <= x)
+    {
+        ++index;
+    }
+
+    if (skyline[index].x < x)
+    {
+        Segment left = skyline[index];
+        left.width = x - left.x;
+        skyline[index].x = x;
+        skyline[index].width -= left.width;
+        skyline.insert(skyline.begin() + index, left);
+        ++index;
+    }
+    skyline.insert(skyline.begin() + index, added);
+
+    // Remove or trim the segments now hidden under the new one.
+    const size_t next = index + 1;
+    while (next < skyline.size() && skyline[next].x < right)
+    {
+        Segment& segment = skyline[next];
+        if (segment.x + segment.width <= right)
+        {
+            skyline.erase(skyline.begin() + next);
+        }
+        else
+        {
+            segment.width -= right - segment.x;
+            segment.x = right;
+            break;
+        }
+    }
+
+    // Join neighbors at the same height so the skyline stays short.
+    for (size_t ii = 1; ii < skyline.size();)
+    {
+        if (skyline[ii - 1].y == skyline[ii].y)
+        {
+            skyline[ii - 1].width += skyline[ii].width;
+            skyline.erase(skyline.begin() + ii);
+        }
+        else
+        {
+            ++ii;
+        }
+    }
+}
+}
+}
@@ -27,9 +27,75 @@ namespace nyra
 {
 namespace graphics
 {
+/*****************************************************************************/
+Window::Window(size_t eventCapacity) :
+    mEvents(eventCapacity),
+    mNumDroppedEvents(0),
+    mFrameStart(FrameStats::Clock::now())
+{
+}
+
 /*****************************************************************************/
 Window::~Window()
 {
 }
+
+/*****************************************************************************/
+bool Window::postEvent(const Event& event)
+{
+    bool queued;
+    if (event.timestamp == 0)
+    {
+        Event stamped(event);
+        stamped.timestamp = getEventTime();
+        queued = mEvents.push(stamped);
+    }
+    else
+    {
+        queued = mEvents.push(event);
+    }
+
+    if (!queued)
+    {
+        mNumDroppedEvents.fetch_add(1, std::memory_order_relaxed);
+    }
+    return queued;
+}
+
+/*****************************************************************************/
+void Window::markAllDirty()
+{
+    const core::Vector2UI size = getSize();
+    mDirty.add(Rect(0,
+                    0,
+                    static_cast<int32_t>(size.x()),
+                    static_cast<int32_t>(size.y())));
+}
+
+/*****************************************************************************/
+void Window::showDirty(const PixelBuffer& buffer)
+{
+    if (mDirty.isEmpty())
+    {
+        return;
+    }
+
+    showBuffer(buffer, mDirty);
+    mDirty.clear();
+}
+
+/*****************************************************************************/
+size_t Window::finishFrame()
+{
+    const FrameStats::Clock::time_point start = FrameStats::Clock::now();
+    const size_t dropped = mPacer.wait();
+    const FrameStats::Clock::time_point now =
+            mFrameStats.addStageTime(FrameStats::WAIT, start);
+    mFrameStats.endFrame(std::chrono::duration<double>(
+                                 now - mFrameStart).count(),
+                         dropped);
+    mFrameStart = now;
+    return dropped;
+}
 }
 }
@@ -0,0 +1,209 @@
+/******************************************************************************
+ * The MIT License(MIT)
+ *
+ * Copyright(c) 2015 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+#include <string.h>
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <graphics/WindowHeadless.h>
+#include <core/Exception.h>
+
+namespace nyra
+{
+namespace graphics
+{
+/*****************************************************************************/
+WindowHeadless::Timings::Timings() :
+    count(0),
+    total(0.0),
+    minimum(0.0),
+    maximum(0.0),
+    last(0.0)
+{
+}
+
+/*****************************************************************************/
+WindowHeadless::WindowHeadless(const core::Vector2UI& size,
+                               const core::Vector2I& position,
+                               PixelFormat format) :
+    mPosition(position),
+    mFormat(format),
+    mPitch(0),
+    mOpen(true),
+    mNumDumped(0)
+{
+    setSize(size);
+}
+
+/*****************************************************************************/
+void WindowHeadless::setSize(const core::Vector2UI& size)
+{
+    mSize = size;
+    mPitch = size.x() * getBytesPerPixel(mFormat);
+    mPixels.assign(mPitch * size.y(), 0);
+}
+
+/*****************************************************************************/
+void WindowHeadless::setPosition(const core::Vector2I& position)
+{
+    mPosition = position;
+}
+
+/*****************************************************************************/
+core::Vector2UI WindowHeadless::getSize() const
+{
+    return mSize;
+}
+
+/*****************************************************************************/
+core::Vector2I WindowHeadless::getPosition() const
+{
+    return mPosition;
+}
+
+/*****************************************************************************/
+bool WindowHeadless::update()
+{
+    return mOpen;
+}
+
+/*****************************************************************************/
+void WindowHeadless::showBuffer(const void* buffer, size_t size)
+{
+    const std::chrono::steady_clock::time_point start =
+            std::chrono::steady_clock::now();
+    if (!mPixels.empty())
+    {
+        memcpy(&mPixels[0], buffer, std::min(size, mPixels.size()));
+    }
+    finishPresent(start);
+}
+
+/*****************************************************************************/
+void WindowHeadless::showBuffer(const PixelBuffer& buffer)
+{
+    const std::chrono::steady_clock::time_point start =
+            std::chrono::steady_clock::now();
+    PixelBuffer clipped(buffer);
+    clipped.size = core::Vector2UI(std::min(buffer.size.x(), mSize.x()),
+                                   std::min(buffer.size.y(), mSize.y()));
+    if (clipped.size.x() && clipped.size.y())
+    {
+        convertPixels(clipped, &mPixels[0], mPitch, mFormat);
+    }
+    finishPresent(start);
+}
+
+/*****************************************************************************/
+void WindowHeadless::showBuffer(const PixelBuffer& buffer,
+                                const DirtyRegion& region)
+{
+    const std::chrono::steady_clock::time_point start =
+            std::chrono::steady_clock::now();
+    if (!mPixels.empty())
+    {
+        convertRects(buffer,
+                     region.getRects(),
+                     &mPixels[0],
+                     mSize,
+                     mPitch,
+                     mFormat);
+    }
+    finishPresent(start);
+}
+
+/*****************************************************************************/
+void WindowHeadless::close()
+{
+    if (mOpen)
+    {
+        Event event = Event();
+        event.type = Event::QUIT;
+        postEvent(event);
+        mOpen = false;
+    }
+}
+
+/*****************************************************************************/
+void WindowHeadless::saveFrame(const std::string& pathname) const
+{
+    std::ofstream out(pathname.c_str(), std::ios::binary);
+    if (!out)
+    {
+        throw core::Exception("Unable to open " + pathname + " for writing");
+    }
+
+    out << "P6\n" << mSize.x() << " " << mSize.y() << "\n255\n";
+
+    // Convert a row at a time to RGBA8 and drop the alpha channel. An
+    // empty frame is just the header.
+    std::vector<uint8_t> rgba(mSize.x() * 4);
+    std::vector<uint8_t> rgb(mSize.x() * 3);
+    const size_t rows = mSize.x() ? mSize.y() : 0;
+    for (size_t row = 0; row < rows; ++row)
+    {
+        const PixelBuffer source(&mPixels[row * mPitch],
+                                 core::Vector2UI(mSize.x(), 1),
+                                 mFormat,
+                                 mPitch);
+        convertPixels(source, &rgba[0], rgba.size(), RGBA8);
+        for (size_t ii = 0; ii < mSize.x(); ++ii)
+        {
+            rgb[ii * 3] = rgba[ii * 4];
+            rgb[ii * 3 + 1] = rgba[ii * 4 + 1];
+            rgb[ii * 3 + 2] = rgba[ii * 4 + 2];
+        }
+        out.write(reinterpret_cast<const char*>(&rgb[0]), rgb.size());
+    }
+
+    if (!out)
+    {
+        throw core::Exception("Failed to write " + pathname);
+    }
+}
+
+/*****************************************************************************/
+void WindowHeadless::finishPresent(std::chrono::steady_clock::time_point start)
+{
+    // There is no display, so the copy is the whole present.
+    const double seconds = std::chrono::duration<double>(
+            getFrameStats().addStageTime(FrameStats::COPY, start) -
+            start).count();
+    ++mTimings.count;
+    mTimings.total += seconds;
+    mTimings.minimum = mTimings.count == 1 ?
+            seconds : std::min(mTimings.minimum, seconds);
+    mTimings.maximum = std::max(mTimings.maximum, seconds);
+    mTimings.last = seconds;
+
+    if (!mDumpDirectory.empty())
+    {
+        std::ostringstream pathname;
+        pathname << mDumpDirectory << "/frame_" << std::setw(6)
+                 << std::setfill('0') << mNumDumped++ << ".ppm";
+        saveFrame(pathname.str());
+    }
+}
+}
+}
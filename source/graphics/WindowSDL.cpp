@@ -21,6 +21,9 @@
  * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
  * IN THE SOFTWARE.
  *****************************************************************************/
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
 #include <graphics/WindowSDL.h>
 #include <core/Exception.h>
 
@@ -40,10 +43,10 @@ WindowSDL::WindowSDL(const std::string& title,
     }
 
     mWindow = SDL_CreateWindow(title.c_str(),
-                               position.x,
-                               position.y,
-                               size.x,
-                               size.y,
+                               position.x(),
+                               position.y(),
+                               size.x(),
+                               size.y(),
                                SDL_WINDOW_SHOWN);
     if (!mWindow)
     {
@@ -61,54 +64,271 @@ WindowSDL::~WindowSDL()
 /*****************************************************************************/
 void WindowSDL::setSize(const core::Vector2UI& size)
 {
-    SDL_SetWindowSize(mWindow, size.x, size.y);
+    SDL_SetWindowSize(mWindow, size.x(), size.y());
 }
 
 /*****************************************************************************/
 void WindowSDL::setPosition(const core::Vector2I& position)
 {
-    SDL_SetWindowPosition(mWindow, position.x, position.y);
+    SDL_SetWindowPosition(mWindow, position.x(), position.y());
 }
 
 /*****************************************************************************/
 core::Vector2UI WindowSDL::getSize() const
 {
-    return core::Vector2UI(0, 0);
+    int width = 0;
+    int height = 0;
+    SDL_GetWindowSize(mWindow, &width, &height);
+    return core::Vector2UI(width, height);
 }
 
 /*****************************************************************************/
 core::Vector2I WindowSDL::getPosition() const
 {
-    return core::Vector2I(0, 0);
+    int x = 0;
+    int y = 0;
+    SDL_GetWindowPosition(mWindow, &x, &y);
+    return core::Vector2I(x, y);
 }
 
 /*****************************************************************************/
 bool WindowSDL::update()
 {
-    while (SDL_PollEvent(&mEvent) != 0)
+    const FrameStats::Clock::time_point start = FrameStats::Clock::now();
+
+    // Take events out of SDL a batch at a time instead of one call each.
+    SDL_PumpEvents();
+    bool open = true;
+    int count = EVENT_BATCH_SIZE;
+    while (count == EVENT_BATCH_SIZE)
     {
-        if (mEvent.type == SDL_QUIT)
+        count = SDL_PeepEvents(mBatch,
+                               EVENT_BATCH_SIZE,
+                               SDL_GETEVENT,
+                               SDL_FIRSTEVENT,
+                               SDL_LASTEVENT);
+
+        const uint64_t now = getEventTime();
+        for (int ii = 0; ii < count; ++ii)
         {
-            return false;
+            if (mBatch[ii].type == SDL_QUIT)
+            {
+                open = false;
+            }
+
+            Event event;
+            if (translateEvent(mBatch[ii], event))
+            {
+                event.timestamp = now;
+                postEvent(event);
+            }
         }
     }
 
-    return true;
+    getFrameStats().addStageTime(FrameStats::EVENTS, start);
+    return open;
 }
 
 /*****************************************************************************/
 void WindowSDL::showBuffer(const void* buffer, size_t size)
 {
     SDL_Surface* screen = SDL_GetWindowSurface(mWindow);
+    if (!screen)
+    {
+        throw core::Exception("Unable to get SDL window surface!");
+    }
+
+    // The buffer is tightly packed but the surface rows may be padded.
+    const size_t rowSize = static_cast<size_t>(screen->w) *
+                           screen->format->BytesPerPixel;
+    const size_t rows = std::min<size_t>(screen->h,
+                                         rowSize ? size / rowSize : 0);
+    const uint8_t* in = static_cast<const uint8_t*>(buffer);
+
+    FrameStats::Clock::time_point start = FrameStats::Clock::now();
+    lockSurface(screen);
+    for (size_t row = 0; row < rows; ++row)
+    {
+        memcpy(static_cast<uint8_t*>(screen->pixels) + row * screen->pitch,
+               in + row * rowSize,
+               rowSize);
+    }
+    unlockSurface(screen);
+    start = getFrameStats().addStageTime(FrameStats::COPY, start);
+    SDL_UpdateWindowSurface(mWindow);
+    getFrameStats().addStageTime(FrameStats::PRESENT, start);
+}
+
+/*****************************************************************************/
+void WindowSDL::showBuffer(const PixelBuffer& buffer)
+{
+    SDL_Surface* screen = SDL_GetWindowSurface(mWindow);
+    if (!screen)
+    {
+        throw core::Exception("Unable to get SDL window surface!");
+    }
 
-    SDL_LockSurface(screen);
+    const PixelFormat format = getPixelFormat(screen->format->format);
+    PixelBuffer clipped(buffer);
+    clipped.size = core::Vector2UI(
+            std::min<size_t>(buffer.size.x(), screen->w),
+            std::min<size_t>(buffer.size.y(), screen->h));
 
-    const size_t pixels = std::min<size_t>(
-            screen->h * screen->w * screen->format->BytesPerPixel, size);
-    memcpy(screen->pixels, buffer, pixels);
+    FrameStats::Clock::time_point start = FrameStats::Clock::now();
+    lockSurface(screen);
+    convertPixels(clipped, screen->pixels, screen->pitch, format);
+    unlockSurface(screen);
+    start = getFrameStats().addStageTime(FrameStats::COPY, start);
     SDL_UpdateWindowSurface(mWindow);
+    getFrameStats().addStageTime(FrameStats::PRESENT, start);
+}
+
+/*****************************************************************************/
+void WindowSDL::showBuffer(const PixelBuffer& buffer,
+                           const DirtyRegion& region)
+{
+    SDL_Surface* screen = SDL_GetWindowSurface(mWindow);
+    if (!screen)
+    {
+        throw core::Exception("Unable to get SDL window surface!");
+    }
+
+    // Only the changed spans are converted, then SDL is told to copy just
+    // those parts.
+    const PixelFormat format = getPixelFormat(screen->format->format);
+    FrameStats::Clock::time_point start = FrameStats::Clock::now();
+    mConvertedRects.clear();
+    lockSurface(screen);
+    convertRects(buffer,
+                 region.getRects(),
+                 screen->pixels,
+                 core::Vector2UI(screen->w, screen->h),
+                 screen->pitch,
+                 format,
+                 &mConvertedRects);
+    unlockSurface(screen);
+    start = getFrameStats().addStageTime(FrameStats::COPY, start);
+
+    mUpdateRects.resize(mConvertedRects.size());
+    for (size_t ii = 0; ii < mConvertedRects.size(); ++ii)
+    {
+        mUpdateRects[ii].x = mConvertedRects[ii].x;
+        mUpdateRects[ii].y = mConvertedRects[ii].y;
+        mUpdateRects[ii].w = mConvertedRects[ii].width;
+        mUpdateRects[ii].h = mConvertedRects[ii].height;
+    }
 
-    SDL_UnlockSurface(screen);
+    if (!mUpdateRects.empty())
+    {
+        SDL_UpdateWindowSurfaceRects(mWindow,
+                                     &mUpdateRects[0],
+                                     static_cast<int>(mUpdateRects.size()));
+    }
+    getFrameStats().addStageTime(FrameStats::PRESENT, start);
+}
+
+/*****************************************************************************/
+bool WindowSDL::translateEvent(const SDL_Event& source, Event& event)
+{
+    event.sourceTime = source.common.timestamp;
+    switch (source.type)
+    {
+    case SDL_QUIT:
+        event.type = Event::QUIT;
+        return true;
+    case SDL_KEYDOWN:
+    case SDL_KEYUP:
+        event.type = source.type == SDL_KEYDOWN ?
+                Event::KEY_DOWN : Event::KEY_UP;
+        event.key.code = source.key.keysym.sym;
+        event.key.modifiers = source.key.keysym.mod;
+        event.key.repeat = source.key.repeat != 0;
+        return true;
+    case SDL_MOUSEMOTION:
+        event.type = Event::MOUSE_MOTION;
+        event.motion.x = source.motion.x;
+        event.motion.y = source.motion.y;
+        event.motion.deltaX = source.motion.xrel;
+        event.motion.deltaY = source.motion.yrel;
+        return true;
+    case SDL_MOUSEBUTTONDOWN:
+    case SDL_MOUSEBUTTONUP:
+        event.type = source.type == SDL_MOUSEBUTTONDOWN ?
+                Event::MOUSE_BUTTON_DOWN : Event::MOUSE_BUTTON_UP;
+        event.button.x = source.button.x;
+        event.button.y = source.button.y;
+        event.button.button = source.button.button;
+        event.button.clicks = source.button.clicks;
+        return true;
+    case SDL_MOUSEWHEEL:
+        event.type = Event::MOUSE_WHEEL;
+        event.wheel.x = source.wheel.x;
+        event.wheel.y = source.wheel.y;
+        return true;
+    case SDL_WINDOWEVENT:
+        switch (source.window.event)
+        {
+        case SDL_WINDOWEVENT_SIZE_CHANGED:
+            event.type = Event::RESIZED;
+            event.resize.width = source.window.data1;
+            event.resize.height = source.window.data2;
+            return true;
+        case SDL_WINDOWEVENT_FOCUS_GAINED:
+            event.type = Event::FOCUS_GAINED;
+            return true;
+        case SDL_WINDOWEVENT_FOCUS_LOST:
+            event.type = Event::FOCUS_LOST;
+            return true;
+        }
+        return false;
+    }
+    return false;
+}
+
+/*****************************************************************************/
+PixelFormat WindowSDL::getPixelFormat(Uint32 format)
+{
+    // Packed SDL formats are named from the most significant byte, so on
+    // little endian machines the bytes in memory are in reverse order.
+    switch (format)
+    {
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+    case SDL_PIXELFORMAT_ARGB8888:
+    case SDL_PIXELFORMAT_RGB888:
+        return BGRA8;
+    case SDL_PIXELFORMAT_ABGR8888:
+    case SDL_PIXELFORMAT_BGR888:
+        return RGBA8;
+#else
+    case SDL_PIXELFORMAT_BGRA8888:
+    case SDL_PIXELFORMAT_BGRX8888:
+        return BGRA8;
+    case SDL_PIXELFORMAT_RGBA8888:
+    case SDL_PIXELFORMAT_RGBX8888:
+        return RGBA8;
+#endif
+    case SDL_PIXELFORMAT_RGB565:
+        return RGB565;
+    }
+    throw core::Exception("Unsupported SDL window surface format!");
+}
+
+/*****************************************************************************/
+void WindowSDL::lockSurface(SDL_Surface* surface)
+{
+    if (SDL_MUSTLOCK(surface) && SDL_LockSurface(surface) < 0)
+    {
+        throw core::Exception("Unable to lock SDL window surface!");
+    }
+}
+
+/*****************************************************************************/
+void WindowSDL::unlockSurface(SDL_Surface* surface)
+{
+    if (SDL_MUSTLOCK(surface))
+    {
+        SDL_UnlockSurface(surface);
+    }
 }
 }
 }